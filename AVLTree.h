@@ -0,0 +1,111 @@
+/** Link-based implementation of a self-balancing (AVL) binary search tree.
+ Every add and remove restores the AVL property on the way back up the
+ search path, so the height of the tree stays O(log n) regardless of the
+ order in which entries arrive.
+ @file AVLTree.h */
+
+#ifndef AVL_TREE_
+#define AVL_TREE_
+
+#include <memory>
+#include <algorithm>
+#include "BinaryNode.h"
+#include "BinarySearchTree.h"
+
+template<class ItemType, class Compare = DefaultOrder<ItemType>>
+class AVLTree : public BinarySearchTree<ItemType, Compare>
+{
+protected:
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    // Rotation and rebalancing helpers.
+    //------------------------------------------------------------
+    // Height of the left subtree minus height of the right subtree.
+    int balanceFactor(const std::shared_ptr<BinaryNode<ItemType>>& nodePtr) const;
+
+    // Rotates the subtree rooted at nodePtr and returns the new subtree root.
+    // nodePtr must already be detached; the child that moves up is detached
+    // here.
+    std::shared_ptr<BinaryNode<ItemType>> rotateLeft(std::shared_ptr<BinaryNode<ItemType>> nodePtr);
+    std::shared_ptr<BinaryNode<ItemType>> rotateRight(std::shared_ptr<BinaryNode<ItemType>> nodePtr);
+
+    // Restores the AVL property at nodePtr, assuming both of its subtrees
+    // are already AVL trees, and returns the new subtree root.
+    std::shared_ptr<BinaryNode<ItemType>> rebalance(std::shared_ptr<BinaryNode<ItemType>> nodePtr);
+
+    // Rebalances each subtree on the path of an add or remove, bottom-up.
+    void fixUpLink(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink) override;
+
+public:
+    // The comparator and bulk-loading constructors; the minimum-height tree
+    // the latter builds is already an AVL tree.
+    using BinarySearchTree<ItemType, Compare>::BinarySearchTree;
+}; // end AVLTree
+
+
+
+/*********************************************************************************************
+**                   Protected Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+int AVLTree<ItemType, Compare>::balanceFactor(const std::shared_ptr<BinaryNode<ItemType>>& nodePtr) const {
+    return this->getHeightHelper(nodePtr->getLeftChildPtr()) - this->getHeightHelper(nodePtr->getRightChildPtr());
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> AVLTree<ItemType, Compare>::rotateLeft(std::shared_ptr<BinaryNode<ItemType>> nodePtr) {
+    //The right child becomes the root of this subtree, and its left subtree moves under nodePtr
+    this->detachLink(nodePtr->rightChildLink());
+    auto pivotPtr = nodePtr->getRightChildPtr();
+    nodePtr->setRightChildPtr(pivotPtr->getLeftChildPtr());
+    pivotPtr->setLeftChildPtr(nodePtr);
+    nodePtr->updateAugmentation();
+    pivotPtr->updateAugmentation();
+    return pivotPtr;
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> AVLTree<ItemType, Compare>::rotateRight(std::shared_ptr<BinaryNode<ItemType>> nodePtr) {
+    //The left child becomes the root of this subtree, and its right subtree moves under nodePtr
+    this->detachLink(nodePtr->leftChildLink());
+    auto pivotPtr = nodePtr->getLeftChildPtr();
+    nodePtr->setLeftChildPtr(pivotPtr->getRightChildPtr());
+    pivotPtr->setRightChildPtr(nodePtr);
+    nodePtr->updateAugmentation();
+    pivotPtr->updateAugmentation();
+    return pivotPtr;
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> AVLTree<ItemType, Compare>::rebalance(std::shared_ptr<BinaryNode<ItemType>> nodePtr) {
+    if (nodePtr == nullptr) {
+        return nodePtr;
+    }
+    nodePtr->updateAugmentation();
+    int balance = balanceFactor(nodePtr);
+
+    //Left heavy: a left-right case is first turned into a left-left case
+    if (balance > 1) {
+        if (balanceFactor(nodePtr->getLeftChildPtr()) < 0) {
+            this->detachLink(nodePtr->leftChildLink());
+            nodePtr->setLeftChildPtr(rotateLeft(nodePtr->getLeftChildPtr()));
+        }
+        return rotateRight(nodePtr);
+    }
+    //Right heavy: a right-left case is first turned into a right-right case
+    else if (balance < -1) {
+        if (balanceFactor(nodePtr->getRightChildPtr()) > 0) {
+            this->detachLink(nodePtr->rightChildLink());
+            nodePtr->setRightChildPtr(rotateRight(nodePtr->getRightChildPtr()));
+        }
+        return rotateLeft(nodePtr);
+    }
+    return nodePtr;
+}
+
+template<class ItemType, class Compare>
+void AVLTree<ItemType, Compare>::fixUpLink(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink) {
+    subTreeLink = rebalance(subTreeLink);
+}
+
+#endif //AVL_TREE_
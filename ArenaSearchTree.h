@@ -0,0 +1,416 @@
+/** Binary search tree whose nodes are stored in a NodePool.
+ Behaves like BinarySearchTree, but the tree owns a single slab of nodes
+ linked by 32-bit indices instead of one shared_ptr allocation per node.
+ Removed nodes are recycled through the pool's free list, and clear() or
+ the destructor gives the whole slab back in one step. Each node caches
+ the height of its subtree, as BinaryNode does, so getHeight() is O(1).
+ @file ArenaSearchTree.h */
+
+#ifndef ARENA_SEARCH_TREE_
+#define ARENA_SEARCH_TREE_
+
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <string>
+#include "BinaryTreeInterface.h"
+#include "NodePool.h"
+#include "NotFoundException.h"
+#include "PrecondViolatedEcxcep.h"
+
+template<class ItemType>
+class ArenaSearchTree : public BinaryTreeInterface<ItemType>
+{
+private:
+    NodePool<ItemType> pool;
+    std::uint32_t rootIndex;
+    // Nodes on the path of the current add or remove, kept between calls
+    // so that the path does not allocate once it has grown to the height.
+    std::vector<std::uint32_t> pathIndices;
+
+protected:
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    // Helper methods for the public methods.
+    //------------------------------------------------------------
+    // Cached height of the subtree, 0 for NULL_NODE.
+    int getHeightHelper(std::uint32_t subTreeIndex) const;
+
+    // Recomputes the cached heights of the nodes in pathIndices, deepest
+    // first, stopping at the first one that does not change, and empties
+    // the path.
+    void fixUpHeights();
+
+    // Returns the index of the node containing target, or NULL_NODE.
+    std::uint32_t findNode(const ItemType& target) const;
+
+    // Unlinks the node referenced by the link at nodeLink, splicing in its
+    // inorder successor when it has two children, and frees it. The nodes
+    // whose subtrees lose a node below nodeLink are added to pathIndices.
+    void removeNode(std::uint32_t& nodeLink);
+
+    // Traversal skeletons: call nodeAction once for each node of the
+    // subtree in preorder (inorder, postorder), using an explicit stack.
+    template<class NodeAction>
+    void preorderNodes(std::uint32_t subTreeIndex, NodeAction nodeAction) const;
+    template<class NodeAction>
+    void inorderNodes(std::uint32_t subTreeIndex, NodeAction nodeAction) const;
+    template<class NodeAction>
+    void postorderNodes(std::uint32_t subTreeIndex, NodeAction nodeAction) const;
+
+    // Traversal helper methods:
+    void preorder(void visit(ItemType&), std::uint32_t subTreeIndex) const;
+    void inorder(void visit(ItemType&), std::uint32_t subTreeIndex) const;
+    void postorder(void visit(ItemType&), std::uint32_t subTreeIndex) const;
+
+public:
+    //------------------------------------------------------------
+    // Constructor and Destructor Section.
+    //------------------------------------------------------------
+    ArenaSearchTree();
+    ArenaSearchTree(const ArenaSearchTree<ItemType>& tree) = default;
+    virtual ~ArenaSearchTree() = default;
+
+    //------------------------------------------------------------
+    // Public BinaryTreeInterface Methods Section.
+    //------------------------------------------------------------
+    bool isEmpty() const override;
+    int getHeight() const override;
+    int getNumberOfNodes() const override;
+    ItemType getRootData() const override;
+    void setRootData(const ItemType& newData) override;
+    bool add(const ItemType& newEntry) override;
+    bool remove(const ItemType& anEntry) override;
+    void clear() override;
+    ItemType getEntry(const ItemType& anEntry) const override;
+    bool contains(const ItemType& anEntry) const override;
+
+    // Returns a pointer to the stored entry matching anEntry, or nullptr.
+    // The pointer is invalidated by the next add, remove or clear.
+    const ItemType* findEntry(const ItemType& anEntry) const;
+
+    //------------------------------------------------------------
+    // Public Traversals Section.
+    //------------------------------------------------------------
+    void preorderTraverse(void visit(ItemType&)) const override;
+    void inorderTraverse(void visit(ItemType&)) const override;
+    void postorderTraverse(void visit(ItemType&)) const override;
+
+    // Read-only traversals that hand any callable visit the stored item
+    // without copying it.
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void preorderTraverse(Visitor visit) const;
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void inorderTraverse(Visitor visit) const;
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void postorderTraverse(Visitor visit) const;
+
+    //------------------------------------------------------------
+    // Node Storage Section.
+    //------------------------------------------------------------
+    // Preallocates room for count nodes so that adds do not grow the slab.
+    void reserve(std::size_t count);
+    NodePoolStats getPoolStats() const;
+    void resetPoolStats();
+
+    ArenaSearchTree& operator=(const ArenaSearchTree& rightHandSide) = default;
+}; // end ArenaSearchTree
+
+
+
+/*********************************************************************************************
+**                   Protected Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType>
+int ArenaSearchTree<ItemType>::getHeightHelper(std::uint32_t subTreeIndex) const {
+    return (subTreeIndex == NULL_NODE) ? 0 : pool[subTreeIndex].height;
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::fixUpHeights() {
+    //Only the path's subtrees changed, so once one keeps its height every ancestor does too
+    while (!pathIndices.empty()) {
+        ArenaNode<ItemType>& node = pool[pathIndices.back()];
+        pathIndices.pop_back();
+        int newHeight = 1 + std::max(getHeightHelper(node.leftChild), getHeightHelper(node.rightChild));
+        if (newHeight == node.height)
+            break;
+        node.height = newHeight;
+    }
+    pathIndices.clear();
+}
+
+template<class ItemType>
+std::uint32_t ArenaSearchTree<ItemType>::findNode(const ItemType& target) const {
+    std::uint32_t currentIndex = rootIndex;
+    while (currentIndex != NULL_NODE) {
+        const ArenaNode<ItemType>& node = pool[currentIndex];
+        if (node.item == target)
+            return currentIndex;
+        currentIndex = (node.item > target) ? node.leftChild : node.rightChild;
+    }
+    return NULL_NODE;
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::removeNode(std::uint32_t& nodeLink) {
+    std::uint32_t nodeIndex = nodeLink;
+    ArenaNode<ItemType>& node = pool[nodeIndex];
+
+    //Zero or one child: the parent link skips straight to the child
+    if (node.leftChild == NULL_NODE) {
+        nodeLink = node.rightChild;
+    }
+    else if (node.rightChild == NULL_NODE) {
+        nodeLink = node.leftChild;
+    }
+    else {
+        //Two children: move the inorder successor's item here and free the successor instead
+        pathIndices.push_back(nodeIndex);
+        std::uint32_t* successorLink = &node.rightChild;
+        while (pool[*successorLink].leftChild != NULL_NODE) {
+            pathIndices.push_back(*successorLink);
+            successorLink = &pool[*successorLink].leftChild;
+        }
+        nodeIndex = *successorLink;
+        node.item = std::move(pool[nodeIndex].item);
+        *successorLink = pool[nodeIndex].rightChild;
+    }
+    pool.release(nodeIndex);
+}
+
+template<class ItemType>
+template<class NodeAction>
+void ArenaSearchTree<ItemType>::preorderNodes(std::uint32_t subTreeIndex, NodeAction nodeAction) const {
+    std::vector<std::uint32_t> nodeStack;
+    if (subTreeIndex != NULL_NODE)
+        nodeStack.push_back(subTreeIndex);
+    while (!nodeStack.empty()) {
+        const ArenaNode<ItemType>& node = pool[nodeStack.back()];
+        nodeStack.pop_back();
+        nodeAction(node);
+        if (node.rightChild != NULL_NODE)
+            nodeStack.push_back(node.rightChild);
+        if (node.leftChild != NULL_NODE)
+            nodeStack.push_back(node.leftChild);
+    }
+}
+
+template<class ItemType>
+template<class NodeAction>
+void ArenaSearchTree<ItemType>::inorderNodes(std::uint32_t subTreeIndex, NodeAction nodeAction) const {
+    std::vector<std::uint32_t> nodeStack;
+    std::uint32_t currentIndex = subTreeIndex;
+    while (currentIndex != NULL_NODE || !nodeStack.empty()) {
+        while (currentIndex != NULL_NODE) {
+            nodeStack.push_back(currentIndex);
+            currentIndex = pool[currentIndex].leftChild;
+        }
+        const ArenaNode<ItemType>& node = pool[nodeStack.back()];
+        nodeStack.pop_back();
+        nodeAction(node);
+        currentIndex = node.rightChild;
+    }
+}
+
+template<class ItemType>
+template<class NodeAction>
+void ArenaSearchTree<ItemType>::postorderNodes(std::uint32_t subTreeIndex, NodeAction nodeAction) const {
+    std::vector<std::uint32_t> nodeStack;
+    std::uint32_t currentIndex = subTreeIndex;
+    std::uint32_t lastVisitedIndex = NULL_NODE;
+    while (currentIndex != NULL_NODE || !nodeStack.empty()) {
+        if (currentIndex != NULL_NODE) {
+            nodeStack.push_back(currentIndex);
+            currentIndex = pool[currentIndex].leftChild;
+        }
+        else {
+            //A node is visited once its right subtree is empty or has just been visited
+            std::uint32_t topIndex = nodeStack.back();
+            std::uint32_t rightIndex = pool[topIndex].rightChild;
+            if (rightIndex != NULL_NODE && rightIndex != lastVisitedIndex) {
+                currentIndex = rightIndex;
+            }
+            else {
+                nodeAction(pool[topIndex]);
+                lastVisitedIndex = topIndex;
+                nodeStack.pop_back();
+            }
+        }
+    }
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::preorder(void visit(ItemType&), std::uint32_t subTreeIndex) const {
+    preorderNodes(subTreeIndex, [visit](const ArenaNode<ItemType>& node) {
+        ItemType theItem = node.item;
+        visit(theItem);
+    });
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::inorder(void visit(ItemType&), std::uint32_t subTreeIndex) const {
+    inorderNodes(subTreeIndex, [visit](const ArenaNode<ItemType>& node) {
+        ItemType theItem = node.item;
+        visit(theItem);
+    });
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::postorder(void visit(ItemType&), std::uint32_t subTreeIndex) const {
+    postorderNodes(subTreeIndex, [visit](const ArenaNode<ItemType>& node) {
+        ItemType theItem = node.item;
+        visit(theItem);
+    });
+}
+
+/*********************************************************************************************
+**                      Public Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType>
+ArenaSearchTree<ItemType>::ArenaSearchTree()
+        : rootIndex(NULL_NODE)
+{ }
+
+template<class ItemType>
+bool ArenaSearchTree<ItemType>::isEmpty() const {
+    return rootIndex == NULL_NODE;
+}
+
+template<class ItemType>
+int ArenaSearchTree<ItemType>::getHeight() const {
+    return getHeightHelper(rootIndex);
+}
+
+template<class ItemType>
+int ArenaSearchTree<ItemType>::getNumberOfNodes() const {
+    //Every live node in the pool belongs to the tree
+    return static_cast<int>(pool.getLiveCount());
+}
+
+template<class ItemType>
+ItemType ArenaSearchTree<ItemType>::getRootData() const {
+    if (isEmpty())
+        throw PrecondViolatedExcep("getRootData() called with empty tree.");
+    return pool[rootIndex].item;
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::setRootData(const ItemType&) {
+    std::string message = "Unable to set or change root, please do not use this public method\n";
+    throw(PrecondViolatedExcep(message));
+}
+
+template<class ItemType>
+bool ArenaSearchTree<ItemType>::add(const ItemType& newEntry) {
+    //Allocate first: growing the slab may move nodes, which would invalidate the links walked below,
+    //and newEntry too if it is an entry of this tree, so the walk compares the node's own copy
+    std::uint32_t newIndex = pool.allocate(newEntry);
+    const ItemType& addedItem = pool[newIndex].item;
+    pathIndices.clear();
+    std::uint32_t* link = &rootIndex;
+    while (*link != NULL_NODE) {
+        pathIndices.push_back(*link);
+        ArenaNode<ItemType>& node = pool[*link];
+        link = (node.item > addedItem) ? &node.leftChild : &node.rightChild;
+    }
+    *link = newIndex;
+    fixUpHeights();
+    return true;
+}
+
+template<class ItemType>
+bool ArenaSearchTree<ItemType>::remove(const ItemType& anEntry) {
+    pathIndices.clear();
+    std::uint32_t* link = &rootIndex;
+    while (*link != NULL_NODE) {
+        ArenaNode<ItemType>& node = pool[*link];
+        if (node.item == anEntry) {
+            removeNode(*link);
+            fixUpHeights();
+            return true;
+        }
+        pathIndices.push_back(*link);
+        link = (node.item > anEntry) ? &node.leftChild : &node.rightChild;
+    }
+    pathIndices.clear();
+    return false;
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::clear() {
+    pool.clear();
+    rootIndex = NULL_NODE;
+}
+
+template<class ItemType>
+ItemType ArenaSearchTree<ItemType>::getEntry(const ItemType& anEntry) const {
+    const ItemType* storedEntry = findEntry(anEntry);
+    if (storedEntry == nullptr) {
+        std::string message = "Item not found within binary tree.";
+        throw(NotFoundException(message));
+    }
+    return *storedEntry;
+}
+
+template<class ItemType>
+bool ArenaSearchTree<ItemType>::contains(const ItemType& anEntry) const {
+    return findNode(anEntry) != NULL_NODE;
+}
+
+template<class ItemType>
+const ItemType* ArenaSearchTree<ItemType>::findEntry(const ItemType& anEntry) const {
+    std::uint32_t nodeIndex = findNode(anEntry);
+    return (nodeIndex == NULL_NODE) ? nullptr : &pool[nodeIndex].item;
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::preorderTraverse(void visit(ItemType&)) const {
+    preorder(visit, rootIndex);
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::inorderTraverse(void visit(ItemType&)) const {
+    inorder(visit, rootIndex);
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::postorderTraverse(void visit(ItemType&)) const {
+    postorder(visit, rootIndex);
+}
+
+template<class ItemType>
+template<class Visitor, class>
+void ArenaSearchTree<ItemType>::preorderTraverse(Visitor visit) const {
+    preorderNodes(rootIndex, [&visit](const ArenaNode<ItemType>& node) { visit(node.item); });
+}
+
+template<class ItemType>
+template<class Visitor, class>
+void ArenaSearchTree<ItemType>::inorderTraverse(Visitor visit) const {
+    inorderNodes(rootIndex, [&visit](const ArenaNode<ItemType>& node) { visit(node.item); });
+}
+
+template<class ItemType>
+template<class Visitor, class>
+void ArenaSearchTree<ItemType>::postorderTraverse(Visitor visit) const {
+    postorderNodes(rootIndex, [&visit](const ArenaNode<ItemType>& node) { visit(node.item); });
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::reserve(std::size_t count) {
+    pool.reserve(count);
+}
+
+template<class ItemType>
+NodePoolStats ArenaSearchTree<ItemType>::getPoolStats() const {
+    return pool.getStats();
+}
+
+template<class ItemType>
+void ArenaSearchTree<ItemType>::resetPoolStats() {
+    pool.resetStats();
+}
+
+#endif //ARENA_SEARCH_TREE_
@@ -0,0 +1,651 @@
+/** B+ tree of integer keys with wide, vector-searched nodes.
+ Each node holds up to WIDE_NODE_CAPACITY sorted keys, so a lookup
+ touches a handful of nodes instead of one node per level of a binary
+ tree, and each node is searched with the branch-free kernel in
+ KeySearch.h (AVX2/SSE2 for 32-bit keys). Entries live only in the
+ leaves, which are linked in key order. A key that is added more than
+ once is stored once with a count, so add, remove, contains and the
+ traversals behave exactly as they do on BinarySearchTree.
+ @file BPlusTree.h */
+
+#ifndef B_PLUS_TREE_
+#define B_PLUS_TREE_
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BinaryTreeInterface.h"
+#include "KeySearch.h"
+#include "NotFoundException.h"
+#include "PrecondViolatedEcxcep.h"
+
+// Most keys a node holds. 32 four-byte keys fill two cache lines and are
+// searched with four AVX2 compares.
+const int WIDE_NODE_CAPACITY = 32;
+
+// Fewest keys a node other than the root holds.
+const int WIDE_NODE_MIN_KEYS = WIDE_NODE_CAPACITY / 2;
+
+template<class ItemType>
+struct WideNode
+{
+    bool     isLeaf;
+    int      keyCount;
+    // Slots past keyCount hold the largest ItemType, so a search can scan
+    // all WIDE_NODE_CAPACITY slots without a tail. The extra slot holds an
+    // overflowing key until the node is split.
+    ItemType keys[WIDE_NODE_CAPACITY + 1];
+
+    explicit WideNode(bool leaf);
+}; // end WideNode
+
+template<class ItemType>
+struct WideLeafNode : public WideNode<ItemType>
+{
+    int                     counts[WIDE_NODE_CAPACITY + 1]; // Copies of each key
+    WideLeafNode<ItemType>* nextLeaf;                       // Leaf with the next larger keys
+
+    WideLeafNode();
+}; // end WideLeafNode
+
+template<class ItemType>
+struct WideInnerNode : public WideNode<ItemType>
+{
+    // children[i] holds the keys in [keys[i - 1], keys[i]).
+    WideNode<ItemType>* children[WIDE_NODE_CAPACITY + 2];
+
+    WideInnerNode();
+}; // end WideInnerNode
+
+template<class ItemType>
+class BPlusTree : public BinaryTreeInterface<ItemType>
+{
+    static_assert(std::is_integral<ItemType>::value, "BPlusTree needs an integral key type");
+
+private:
+    WideNode<ItemType>* rootPtr;
+    int itemCount;
+
+protected:
+    // The inner nodes on the way down to a leaf, each with the index of the
+    // child that was followed.
+    typedef std::vector<std::pair<WideInnerNode<ItemType>*, int>> NodePath;
+
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    // Helper methods for the public methods. They use loops and explicit
+    // stacks, like the other trees.
+    //------------------------------------------------------------
+    // Number of keys in the node less than (not greater than) key. The
+    // first is where key belongs in a leaf; the second is the child of an
+    // inner node whose range holds key.
+    static int lowerBound(const WideNode<ItemType>* nodePtr, const ItemType& key);
+    static int upperBound(const WideNode<ItemType>* nodePtr, const ItemType& key);
+
+    // Walks from the root to the leaf whose range holds key, recording the
+    // path in path when it is not nullptr. The tree must not be empty.
+    WideLeafNode<ItemType>* findLeaf(const ItemType& key, NodePath* path) const;
+
+    // Returns the leaf holding the smallest keys, or nullptr.
+    WideLeafNode<ItemType>* leftmostLeaf(WideNode<ItemType>* subTreePtr) const;
+
+    // Insert or erase one slot, shifting the slots after it and keeping the
+    // padding past keyCount. An inner node's new child goes to the right
+    // of the new key; erasing a key also drops the child to its right.
+    static void leafInsert(WideLeafNode<ItemType>* leafPtr, int position, const ItemType& key, int count);
+    static void leafErase(WideLeafNode<ItemType>* leafPtr, int position);
+    static void innerInsert(WideInnerNode<ItemType>* innerPtr, int position, const ItemType& key,
+                            WideNode<ItemType>* rightChildPtr);
+    static void innerErase(WideInnerNode<ItemType>* innerPtr, int position);
+
+    // Moves the upper half of an overfull node into a new right sibling,
+    // which it returns; separator receives the key that divides them.
+    static WideNode<ItemType>* splitNode(WideNode<ItemType>* nodePtr, ItemType& separator);
+
+    // Brings the child at childIndex of parentPtr back up to
+    // WIDE_NODE_MIN_KEYS by borrowing a key from a sibling, or else by
+    // merging it with a sibling.
+    static void fixUnderflow(WideInnerNode<ItemType>* parentPtr, int childIndex);
+
+    // Frees one node as its own type; its children are not touched.
+    static void deleteNode(WideNode<ItemType>* nodePtr);
+
+    // Frees every node of a subtree.
+    static void destroyTree(WideNode<ItemType>* subTreePtr);
+
+    // Copies a subtree, relinking the copied leaves in order.
+    static WideNode<ItemType>* copyTree(const WideNode<ItemType>* subTreePtr);
+
+    // Calls entryAction once for every copy of every entry, in sorted order.
+    template<class EntryAction>
+    void forEachEntry(EntryAction entryAction) const;
+
+public:
+    //------------------------------------------------------------
+    // Constructor and Destructor Section.
+    //------------------------------------------------------------
+    BPlusTree();
+    BPlusTree(const BPlusTree<ItemType>& tree);
+    virtual ~BPlusTree();
+
+    //------------------------------------------------------------
+    // Public BinaryTreeInterface Methods Section.
+    //------------------------------------------------------------
+    bool isEmpty() const override;
+    int getHeight() const override;        // Levels of nodes
+    int getNumberOfNodes() const override; // Entries, counting each copy
+
+    // Gets the entry that splits the root: the smallest entry of its second
+    // subtree, or the smallest entry when the root is a leaf.
+    ItemType getRootData() const override;
+    void setRootData(const ItemType& newData) override;
+    bool add(const ItemType& newEntry) override;
+    bool remove(const ItemType& anEntry) override;
+    void clear() override;
+    ItemType getEntry(const ItemType& anEntry) const override;
+    bool contains(const ItemType& anEntry) const override;
+
+    // Returns a pointer to the stored entry matching anEntry, or nullptr.
+    // The pointer is invalidated by the next add, remove or clear.
+    const ItemType* findEntry(const ItemType& anEntry) const;
+
+    //------------------------------------------------------------
+    // Public Traversals Section.
+    // Every entry is in a leaf, so all three orders visit the entries in
+    // sorted order.
+    //------------------------------------------------------------
+    void preorderTraverse(void visit(ItemType&)) const override;
+    void inorderTraverse(void visit(ItemType&)) const override;
+    void postorderTraverse(void visit(ItemType&)) const override;
+
+    // Read-only traversal that hands any callable visit the stored entry.
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void inorderTraverse(Visitor visit) const;
+
+    BPlusTree& operator=(const BPlusTree& rightHandSide);
+}; // end BPlusTree
+
+
+
+/*********************************************************************************************
+**                   Node Implementations                                                   **
+*********************************************************************************************/
+template<class ItemType>
+WideNode<ItemType>::WideNode(bool leaf)
+        : isLeaf(leaf), keyCount(0)
+{
+    std::fill(keys, keys + WIDE_NODE_CAPACITY + 1, std::numeric_limits<ItemType>::max());
+}
+
+template<class ItemType>
+WideLeafNode<ItemType>::WideLeafNode()
+        : WideNode<ItemType>(true), nextLeaf(nullptr)
+{ }
+
+template<class ItemType>
+WideInnerNode<ItemType>::WideInnerNode()
+        : WideNode<ItemType>(false)
+{ }
+
+/*********************************************************************************************
+**                   Protected Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType>
+int BPlusTree<ItemType>::lowerBound(const WideNode<ItemType>* nodePtr, const ItemType& key) {
+    //The padding is never less than key, so the whole node can be scanned
+    return countLess(static_cast<const ItemType*>(nodePtr->keys), WIDE_NODE_CAPACITY, key);
+}
+
+template<class ItemType>
+int BPlusTree<ItemType>::upperBound(const WideNode<ItemType>* nodePtr, const ItemType& key) {
+    //Keys not greater than key are the keys less than key + 1
+    if (key == std::numeric_limits<ItemType>::max())
+        return nodePtr->keyCount;
+    return countLess(static_cast<const ItemType*>(nodePtr->keys), WIDE_NODE_CAPACITY, static_cast<ItemType>(key + 1));
+}
+
+template<class ItemType>
+WideLeafNode<ItemType>* BPlusTree<ItemType>::findLeaf(const ItemType& key, NodePath* path) const {
+    WideNode<ItemType>* nodePtr = rootPtr;
+    while (!nodePtr->isLeaf) {
+        auto innerPtr = static_cast<WideInnerNode<ItemType>*>(nodePtr);
+        int childIndex = upperBound(innerPtr, key);
+        if (path != nullptr)
+            path->emplace_back(innerPtr, childIndex);
+        nodePtr = innerPtr->children[childIndex];
+    }
+    return static_cast<WideLeafNode<ItemType>*>(nodePtr);
+}
+
+template<class ItemType>
+WideLeafNode<ItemType>* BPlusTree<ItemType>::leftmostLeaf(WideNode<ItemType>* subTreePtr) const {
+    if (subTreePtr == nullptr)
+        return nullptr;
+    while (!subTreePtr->isLeaf) {
+        subTreePtr = static_cast<WideInnerNode<ItemType>*>(subTreePtr)->children[0];
+    }
+    return static_cast<WideLeafNode<ItemType>*>(subTreePtr);
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::leafInsert(WideLeafNode<ItemType>* leafPtr, int position, const ItemType& key, int count) {
+    int keyCount = leafPtr->keyCount;
+    std::copy_backward(leafPtr->keys + position, leafPtr->keys + keyCount, leafPtr->keys + keyCount + 1);
+    std::copy_backward(leafPtr->counts + position, leafPtr->counts + keyCount, leafPtr->counts + keyCount + 1);
+    leafPtr->keys[position] = key;
+    leafPtr->counts[position] = count;
+    leafPtr->keyCount++;
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::leafErase(WideLeafNode<ItemType>* leafPtr, int position) {
+    int keyCount = leafPtr->keyCount;
+    std::copy(leafPtr->keys + position + 1, leafPtr->keys + keyCount, leafPtr->keys + position);
+    std::copy(leafPtr->counts + position + 1, leafPtr->counts + keyCount, leafPtr->counts + position);
+    leafPtr->keyCount--;
+    leafPtr->keys[leafPtr->keyCount] = std::numeric_limits<ItemType>::max();
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::innerInsert(WideInnerNode<ItemType>* innerPtr, int position, const ItemType& key,
+                                      WideNode<ItemType>* rightChildPtr) {
+    int keyCount = innerPtr->keyCount;
+    std::copy_backward(innerPtr->keys + position, innerPtr->keys + keyCount, innerPtr->keys + keyCount + 1);
+    std::copy_backward(innerPtr->children + position + 1, innerPtr->children + keyCount + 1,
+                       innerPtr->children + keyCount + 2);
+    innerPtr->keys[position] = key;
+    innerPtr->children[position + 1] = rightChildPtr;
+    innerPtr->keyCount++;
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::innerErase(WideInnerNode<ItemType>* innerPtr, int position) {
+    int keyCount = innerPtr->keyCount;
+    std::copy(innerPtr->keys + position + 1, innerPtr->keys + keyCount, innerPtr->keys + position);
+    std::copy(innerPtr->children + position + 2, innerPtr->children + keyCount + 1, innerPtr->children + position + 1);
+    innerPtr->keyCount--;
+    innerPtr->keys[innerPtr->keyCount] = std::numeric_limits<ItemType>::max();
+}
+
+template<class ItemType>
+WideNode<ItemType>* BPlusTree<ItemType>::splitNode(WideNode<ItemType>* nodePtr, ItemType& separator) {
+    const ItemType padding = std::numeric_limits<ItemType>::max();
+    int keyCount = nodePtr->keyCount;
+    if (nodePtr->isLeaf) {
+        //The right leaf starts at the separator, which stays an entry of the leaf level
+        auto leafPtr = static_cast<WideLeafNode<ItemType>*>(nodePtr);
+        auto siblingPtr = new WideLeafNode<ItemType>();
+        int leftCount = keyCount - keyCount / 2;
+        std::copy(leafPtr->keys + leftCount, leafPtr->keys + keyCount, siblingPtr->keys);
+        std::copy(leafPtr->counts + leftCount, leafPtr->counts + keyCount, siblingPtr->counts);
+        std::fill(leafPtr->keys + leftCount, leafPtr->keys + keyCount, padding);
+        siblingPtr->keyCount = keyCount - leftCount;
+        leafPtr->keyCount = leftCount;
+        siblingPtr->nextLeaf = leafPtr->nextLeaf;
+        leafPtr->nextLeaf = siblingPtr;
+        separator = siblingPtr->keys[0];
+        return siblingPtr;
+    }
+
+    //The middle key moves up to the parent, and the keys after it move to the sibling
+    auto innerPtr = static_cast<WideInnerNode<ItemType>*>(nodePtr);
+    auto siblingPtr = new WideInnerNode<ItemType>();
+    int middle = keyCount / 2;
+    separator = innerPtr->keys[middle];
+    std::copy(innerPtr->keys + middle + 1, innerPtr->keys + keyCount, siblingPtr->keys);
+    std::copy(innerPtr->children + middle + 1, innerPtr->children + keyCount + 1, siblingPtr->children);
+    std::fill(innerPtr->keys + middle, innerPtr->keys + keyCount, padding);
+    siblingPtr->keyCount = keyCount - middle - 1;
+    innerPtr->keyCount = middle;
+    return siblingPtr;
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::fixUnderflow(WideInnerNode<ItemType>* parentPtr, int childIndex) {
+    const ItemType padding = std::numeric_limits<ItemType>::max();
+    WideNode<ItemType>* nodePtr = parentPtr->children[childIndex];
+    WideNode<ItemType>* leftPtr = (childIndex > 0) ? parentPtr->children[childIndex - 1] : nullptr;
+    WideNode<ItemType>* rightPtr = (childIndex < parentPtr->keyCount) ? parentPtr->children[childIndex + 1] : nullptr;
+
+    if (nodePtr->isLeaf) {
+        auto leafPtr = static_cast<WideLeafNode<ItemType>*>(nodePtr);
+        auto leftLeafPtr = static_cast<WideLeafNode<ItemType>*>(leftPtr);
+        auto rightLeafPtr = static_cast<WideLeafNode<ItemType>*>(rightPtr);
+        if ((leftLeafPtr != nullptr) && (leftLeafPtr->keyCount > WIDE_NODE_MIN_KEYS)) {
+            //Take the left sibling's largest key; it becomes the new separator
+            int last = leftLeafPtr->keyCount - 1;
+            leafInsert(leafPtr, 0, leftLeafPtr->keys[last], leftLeafPtr->counts[last]);
+            leafErase(leftLeafPtr, last);
+            parentPtr->keys[childIndex - 1] = leafPtr->keys[0];
+        }
+        else if ((rightLeafPtr != nullptr) && (rightLeafPtr->keyCount > WIDE_NODE_MIN_KEYS)) {
+            //Take the right sibling's smallest key; its next key becomes the separator
+            leafInsert(leafPtr, leafPtr->keyCount, rightLeafPtr->keys[0], rightLeafPtr->counts[0]);
+            leafErase(rightLeafPtr, 0);
+            parentPtr->keys[childIndex] = rightLeafPtr->keys[0];
+        }
+        else {
+            //Merge the right one of the pair into the left one
+            if (leftLeafPtr == nullptr) {
+                leftLeafPtr = leafPtr;
+                leafPtr = rightLeafPtr;
+                childIndex++;
+            }
+            std::copy(leafPtr->keys, leafPtr->keys + leafPtr->keyCount, leftLeafPtr->keys + leftLeafPtr->keyCount);
+            std::copy(leafPtr->counts, leafPtr->counts + leafPtr->keyCount, leftLeafPtr->counts + leftLeafPtr->keyCount);
+            leftLeafPtr->keyCount += leafPtr->keyCount;
+            leftLeafPtr->nextLeaf = leafPtr->nextLeaf;
+            innerErase(parentPtr, childIndex - 1);
+            deleteNode(leafPtr);
+        }
+        return;
+    }
+
+    auto innerPtr = static_cast<WideInnerNode<ItemType>*>(nodePtr);
+    auto leftInnerPtr = static_cast<WideInnerNode<ItemType>*>(leftPtr);
+    auto rightInnerPtr = static_cast<WideInnerNode<ItemType>*>(rightPtr);
+    if ((leftInnerPtr != nullptr) && (leftInnerPtr->keyCount > WIDE_NODE_MIN_KEYS)) {
+        //Rotate right: the separator comes down in front, the left sibling's last key goes up
+        int keyCount = innerPtr->keyCount;
+        int last = leftInnerPtr->keyCount - 1;
+        std::copy_backward(innerPtr->keys, innerPtr->keys + keyCount, innerPtr->keys + keyCount + 1);
+        std::copy_backward(innerPtr->children, innerPtr->children + keyCount + 1, innerPtr->children + keyCount + 2);
+        innerPtr->keys[0] = parentPtr->keys[childIndex - 1];
+        innerPtr->children[0] = leftInnerPtr->children[last + 1];
+        innerPtr->keyCount++;
+        parentPtr->keys[childIndex - 1] = leftInnerPtr->keys[last];
+        leftInnerPtr->keys[last] = padding;
+        leftInnerPtr->keyCount--;
+    }
+    else if ((rightInnerPtr != nullptr) && (rightInnerPtr->keyCount > WIDE_NODE_MIN_KEYS)) {
+        //Rotate left: the separator comes down at the end, the right sibling's first key goes up
+        int keyCount = rightInnerPtr->keyCount;
+        innerPtr->keys[innerPtr->keyCount] = parentPtr->keys[childIndex];
+        innerPtr->children[innerPtr->keyCount + 1] = rightInnerPtr->children[0];
+        innerPtr->keyCount++;
+        parentPtr->keys[childIndex] = rightInnerPtr->keys[0];
+        std::copy(rightInnerPtr->keys + 1, rightInnerPtr->keys + keyCount, rightInnerPtr->keys);
+        std::copy(rightInnerPtr->children + 1, rightInnerPtr->children + keyCount + 1, rightInnerPtr->children);
+        rightInnerPtr->keys[keyCount - 1] = padding;
+        rightInnerPtr->keyCount--;
+    }
+    else {
+        //Merge the right one of the pair, and the separator between them, into the left one
+        if (leftInnerPtr == nullptr) {
+            leftInnerPtr = innerPtr;
+            innerPtr = rightInnerPtr;
+            childIndex++;
+        }
+        int leftCount = leftInnerPtr->keyCount;
+        leftInnerPtr->keys[leftCount] = parentPtr->keys[childIndex - 1];
+        std::copy(innerPtr->keys, innerPtr->keys + innerPtr->keyCount, leftInnerPtr->keys + leftCount + 1);
+        std::copy(innerPtr->children, innerPtr->children + innerPtr->keyCount + 1, leftInnerPtr->children + leftCount + 1);
+        leftInnerPtr->keyCount += innerPtr->keyCount + 1;
+        innerErase(parentPtr, childIndex - 1);
+        deleteNode(innerPtr);
+    }
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::deleteNode(WideNode<ItemType>* nodePtr) {
+    if (nodePtr->isLeaf)
+        delete static_cast<WideLeafNode<ItemType>*>(nodePtr);
+    else
+        delete static_cast<WideInnerNode<ItemType>*>(nodePtr);
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::destroyTree(WideNode<ItemType>* subTreePtr) {
+    std::vector<WideNode<ItemType>*> nodeStack;
+    if (subTreePtr != nullptr)
+        nodeStack.push_back(subTreePtr);
+    while (!nodeStack.empty()) {
+        WideNode<ItemType>* nodePtr = nodeStack.back();
+        nodeStack.pop_back();
+        if (!nodePtr->isLeaf) {
+            auto innerPtr = static_cast<WideInnerNode<ItemType>*>(nodePtr);
+            nodeStack.insert(nodeStack.end(), innerPtr->children, innerPtr->children + innerPtr->keyCount + 1);
+        }
+        deleteNode(nodePtr);
+    }
+}
+
+template<class ItemType>
+WideNode<ItemType>* BPlusTree<ItemType>::copyTree(const WideNode<ItemType>* subTreePtr) {
+    //Each stacked link still points at the original node it must be replaced with a copy of.
+    //Children are stacked right to left, so the leaves are copied in key order.
+    WideNode<ItemType>* newTreePtr = const_cast<WideNode<ItemType>*>(subTreePtr);
+    WideLeafNode<ItemType>* previousLeafPtr = nullptr;
+    std::vector<WideNode<ItemType>**> linkStack;
+    if (subTreePtr != nullptr)
+        linkStack.push_back(&newTreePtr);
+    while (!linkStack.empty()) {
+        WideNode<ItemType>** link = linkStack.back();
+        linkStack.pop_back();
+        if ((*link)->isLeaf) {
+            auto leafCopyPtr = new WideLeafNode<ItemType>(*static_cast<const WideLeafNode<ItemType>*>(*link));
+            leafCopyPtr->nextLeaf = nullptr;
+            if (previousLeafPtr != nullptr)
+                previousLeafPtr->nextLeaf = leafCopyPtr;
+            previousLeafPtr = leafCopyPtr;
+            *link = leafCopyPtr;
+        }
+        else {
+            auto innerCopyPtr = new WideInnerNode<ItemType>(*static_cast<const WideInnerNode<ItemType>*>(*link));
+            *link = innerCopyPtr;
+            for (int childIndex = innerCopyPtr->keyCount; childIndex >= 0; childIndex--)
+                linkStack.push_back(&innerCopyPtr->children[childIndex]);
+        }
+    }
+    return newTreePtr;
+}
+
+template<class ItemType>
+template<class EntryAction>
+void BPlusTree<ItemType>::forEachEntry(EntryAction entryAction) const {
+    for (WideLeafNode<ItemType>* leafPtr = leftmostLeaf(rootPtr); leafPtr != nullptr; leafPtr = leafPtr->nextLeaf) {
+        for (int position = 0; position < leafPtr->keyCount; position++) {
+            for (int copy = 0; copy < leafPtr->counts[position]; copy++)
+                entryAction(leafPtr->keys[position]);
+        }
+    }
+}
+
+/*********************************************************************************************
+**                      Public Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType>
+BPlusTree<ItemType>::BPlusTree()
+        : rootPtr(nullptr), itemCount(0)
+{ }
+
+template<class ItemType>
+BPlusTree<ItemType>::BPlusTree(const BPlusTree<ItemType>& tree)
+        : rootPtr(copyTree(tree.rootPtr)), itemCount(tree.itemCount)
+{ }
+
+template<class ItemType>
+BPlusTree<ItemType>::~BPlusTree() {
+    destroyTree(rootPtr);
+}
+
+template<class ItemType>
+bool BPlusTree<ItemType>::isEmpty() const {
+    return rootPtr == nullptr;
+}
+
+template<class ItemType>
+int BPlusTree<ItemType>::getHeight() const {
+    //Every leaf is at the same depth
+    int height = 0;
+    for (WideNode<ItemType>* nodePtr = rootPtr; nodePtr != nullptr; height++) {
+        nodePtr = nodePtr->isLeaf ? nullptr : static_cast<WideInnerNode<ItemType>*>(nodePtr)->children[0];
+    }
+    return height;
+}
+
+template<class ItemType>
+int BPlusTree<ItemType>::getNumberOfNodes() const {
+    return itemCount;
+}
+
+template<class ItemType>
+ItemType BPlusTree<ItemType>::getRootData() const {
+    if (isEmpty())
+        throw PrecondViolatedExcep("getRootData() called with empty tree.");
+    WideNode<ItemType>* subTreePtr = rootPtr;
+    if (!subTreePtr->isLeaf)
+        subTreePtr = static_cast<WideInnerNode<ItemType>*>(subTreePtr)->children[1];
+    return leftmostLeaf(subTreePtr)->keys[0];
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::setRootData(const ItemType&) {
+    std::string message = "Unable to set or change root, please do not use this public method\n";
+    throw(PrecondViolatedExcep(message));
+}
+
+template<class ItemType>
+bool BPlusTree<ItemType>::add(const ItemType& newEntry) {
+    itemCount++;
+    if (rootPtr == nullptr) {
+        auto leafPtr = new WideLeafNode<ItemType>();
+        leafInsert(leafPtr, 0, newEntry, 1);
+        rootPtr = leafPtr;
+        return true;
+    }
+
+    NodePath path;
+    path.reserve(getHeight());
+    WideLeafNode<ItemType>* leafPtr = findLeaf(newEntry, &path);
+    int position = lowerBound(leafPtr, newEntry);
+    if ((position < leafPtr->keyCount) && (leafPtr->keys[position] == newEntry)) {
+        leafPtr->counts[position]++;
+        return true;
+    }
+    leafInsert(leafPtr, position, newEntry, 1);
+
+    //Split overfull nodes from the leaf up; a root split adds a level
+    WideNode<ItemType>* nodePtr = leafPtr;
+    while (nodePtr->keyCount > WIDE_NODE_CAPACITY) {
+        ItemType separator;
+        WideNode<ItemType>* siblingPtr = splitNode(nodePtr, separator);
+        if (path.empty()) {
+            auto newRootPtr = new WideInnerNode<ItemType>();
+            newRootPtr->keys[0] = separator;
+            newRootPtr->children[0] = nodePtr;
+            newRootPtr->children[1] = siblingPtr;
+            newRootPtr->keyCount = 1;
+            rootPtr = newRootPtr;
+            break;
+        }
+        innerInsert(path.back().first, path.back().second, separator, siblingPtr);
+        nodePtr = path.back().first;
+        path.pop_back();
+    }
+    return true;
+}
+
+template<class ItemType>
+bool BPlusTree<ItemType>::remove(const ItemType& anEntry) {
+    if (rootPtr == nullptr)
+        return false;
+    NodePath path;
+    path.reserve(getHeight());
+    WideLeafNode<ItemType>* leafPtr = findLeaf(anEntry, &path);
+    int position = lowerBound(leafPtr, anEntry);
+    if ((position == leafPtr->keyCount) || !(leafPtr->keys[position] == anEntry))
+        return false;
+
+    itemCount--;
+    if (leafPtr->counts[position] > 1) {
+        leafPtr->counts[position]--;
+        return true;
+    }
+    leafErase(leafPtr, position);
+
+    //Refill underfull nodes from the leaf up; a root left with one child is dropped
+    WideNode<ItemType>* nodePtr = leafPtr;
+    while (!path.empty() && (nodePtr->keyCount < WIDE_NODE_MIN_KEYS)) {
+        fixUnderflow(path.back().first, path.back().second);
+        nodePtr = path.back().first;
+        path.pop_back();
+    }
+    if (rootPtr->keyCount == 0) {
+        WideNode<ItemType>* oldRootPtr = rootPtr;
+        rootPtr = rootPtr->isLeaf ? nullptr : static_cast<WideInnerNode<ItemType>*>(rootPtr)->children[0];
+        deleteNode(oldRootPtr);
+    }
+    return true;
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::clear() {
+    destroyTree(rootPtr);
+    rootPtr = nullptr;
+    itemCount = 0;
+}
+
+template<class ItemType>
+ItemType BPlusTree<ItemType>::getEntry(const ItemType& anEntry) const {
+    const ItemType* storedEntry = findEntry(anEntry);
+    if (storedEntry == nullptr) {
+        std::string message = "Item not found within binary tree.";
+        throw(NotFoundException(message));
+    }
+    return *storedEntry;
+}
+
+template<class ItemType>
+bool BPlusTree<ItemType>::contains(const ItemType& anEntry) const {
+    return findEntry(anEntry) != nullptr;
+}
+
+template<class ItemType>
+const ItemType* BPlusTree<ItemType>::findEntry(const ItemType& anEntry) const {
+    if (rootPtr == nullptr)
+        return nullptr;
+    WideLeafNode<ItemType>* leafPtr = findLeaf(anEntry, nullptr);
+    int position = lowerBound(leafPtr, anEntry);
+    return ((position < leafPtr->keyCount) && (leafPtr->keys[position] == anEntry)) ? &leafPtr->keys[position] : nullptr;
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::preorderTraverse(void visit(ItemType&)) const {
+    inorderTraverse(visit);
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::inorderTraverse(void visit(ItemType&)) const {
+    forEachEntry([visit](const ItemType& anEntry) {
+        ItemType theItem = anEntry;
+        visit(theItem);
+    });
+}
+
+template<class ItemType>
+void BPlusTree<ItemType>::postorderTraverse(void visit(ItemType&)) const {
+    inorderTraverse(visit);
+}
+
+template<class ItemType>
+template<class Visitor, class>
+void BPlusTree<ItemType>::inorderTraverse(Visitor visit) const {
+    forEachEntry([&visit](const ItemType& anEntry) { visit(anEntry); });
+}
+
+template<class ItemType>
+BPlusTree<ItemType>& BPlusTree<ItemType>::operator=(const BPlusTree<ItemType>& rightHandSide) {
+    if (this != &rightHandSide) {
+        WideNode<ItemType>* newRootPtr = copyTree(rightHandSide.rootPtr);
+        destroyTree(rootPtr);
+        rootPtr = newRootPtr;
+        itemCount = rightHandSide.itemCount;
+    }
+    return *this;
+}
+
+#endif //B_PLUS_TREE_
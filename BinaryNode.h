@@ -10,7 +10,14 @@
 
 
 #include <memory>
+#include <utility>
 #include <cstddef>
+#include "TreeStats.h"
+
+// Selects the BinaryNode constructor that builds its item in place from
+// the remaining arguments.
+struct InPlaceItem { };
+const InPlaceItem IN_PLACE_ITEM = InPlaceItem();
 
 template<class ItemType>
 class BinaryNode
@@ -19,24 +26,58 @@ private:
    ItemType              item;           // Data portion
    std::shared_ptr<BinaryNode<ItemType>> leftChildPtr;   // Pointer to left child
    std::shared_ptr<BinaryNode<ItemType>> rightChildPtr;  // Pointer to right child
+   int                   height;         // Height of the subtree rooted here
+   int                   size;           // Number of nodes in the subtree rooted here
+#if defined(BINARY_TREE_STATS)
+   NodeTally             tally;          // Counts this node's construction and destruction
+#endif
 
 public:
    BinaryNode();
    BinaryNode(const ItemType& anItem);
+   BinaryNode(ItemType&& anItem);
    BinaryNode(const ItemType& anItem,
               std::shared_ptr<BinaryNode<ItemType>> leftPtr,
               std::shared_ptr<BinaryNode<ItemType>> rightPtr);
 
+   // Constructs the item from args, with no copy or move of an ItemType.
+   template<class... Args>
+   explicit BinaryNode(InPlaceItem, Args&&... args);
+
    void setItem(const ItemType& anItem);
-   ItemType getItem() const;
+   void setItem(ItemType&& anItem);
+   const ItemType& getItem() const;
+
+   // Moves the item out of the node, leaving it in a valid but unspecified
+   // state; for removals that are about to overwrite or discard the node.
+   ItemType takeItem();
+
+   // The item itself, for updates that leave its place in the tree's
+   // order unchanged.
+   ItemType& itemRef();
+
+   int getHeight() const;
+   void setHeight(int newHeight);
+
+   int getSize() const;
+   void setSize(int newSize);
+
+   // Recomputes height and size from the children, which must already be
+   // up to date.
+   void updateAugmentation();
 
    bool isLeaf() const;
 
-    std::shared_ptr<BinaryNode<ItemType>> getLeftChildPtr() const;
-    std::shared_ptr<BinaryNode<ItemType>> getRightChildPtr() const;
+    const std::shared_ptr<BinaryNode<ItemType>>& getLeftChildPtr() const;
+    const std::shared_ptr<BinaryNode<ItemType>>& getRightChildPtr() const;
 
    void setLeftChildPtr(std::shared_ptr<BinaryNode<ItemType>> leftPtr);
    void setRightChildPtr(std::shared_ptr<BinaryNode<ItemType>> rightPtr);
+
+   // The child links themselves, for algorithms that walk down a tree and
+   // relink it in place without copying a shared_ptr at every level.
+   std::shared_ptr<BinaryNode<ItemType>>& leftChildLink();
+   std::shared_ptr<BinaryNode<ItemType>>& rightChildLink();
 }; // end BinaryNode
 
 
@@ -45,19 +86,32 @@ public:
 *******************************************************************************/
 template<class ItemType>
 BinaryNode<ItemType>::BinaryNode()
-        : leftChildPtr(nullptr), rightChildPtr(nullptr)
+        : leftChildPtr(nullptr), rightChildPtr(nullptr), height(1), size(1)
 { }  // end default constructor
 
 template<class ItemType>
 BinaryNode<ItemType>::BinaryNode(const ItemType& anItem)
-        : item(anItem), leftChildPtr(nullptr), rightChildPtr(nullptr)
+        : item(anItem), leftChildPtr(nullptr), rightChildPtr(nullptr), height(1), size(1)
+{ }  // end constructor
+
+template<class ItemType>
+BinaryNode<ItemType>::BinaryNode(ItemType&& anItem)
+        : item(std::move(anItem)), leftChildPtr(nullptr), rightChildPtr(nullptr), height(1), size(1)
 { }  // end constructor
 
 template<class ItemType>
 BinaryNode<ItemType>::BinaryNode(const ItemType& anItem,
                                  std::shared_ptr<BinaryNode<ItemType>> leftPtr,
                                  std::shared_ptr<BinaryNode<ItemType>> rightPtr)
-        : item(anItem), leftChildPtr(leftPtr), rightChildPtr(rightPtr)
+        : item(anItem), leftChildPtr(std::move(leftPtr)), rightChildPtr(std::move(rightPtr))
+{
+    updateAugmentation();
+}  // end constructor
+
+template<class ItemType>
+template<class... Args>
+BinaryNode<ItemType>::BinaryNode(InPlaceItem, Args&&... args)
+        : item(std::forward<Args>(args)...), leftChildPtr(nullptr), rightChildPtr(nullptr), height(1), size(1)
 { }  // end constructor
 
 template<class ItemType>
@@ -67,11 +121,63 @@ void BinaryNode<ItemType>::setItem(const ItemType& anItem)
 }  // end setItem
 
 template<class ItemType>
-ItemType BinaryNode<ItemType>::getItem() const
+void BinaryNode<ItemType>::setItem(ItemType&& anItem)
+{
+    item = std::move(anItem);
+}  // end setItem
+
+template<class ItemType>
+ItemType BinaryNode<ItemType>::takeItem()
+{
+    return std::move(item);
+}  // end takeItem
+
+template<class ItemType>
+ItemType& BinaryNode<ItemType>::itemRef()
+{
+    return item;
+}  // end itemRef
+
+template<class ItemType>
+const ItemType& BinaryNode<ItemType>::getItem() const
 {
     return item;
 }  // end getItem
 
+template<class ItemType>
+int BinaryNode<ItemType>::getHeight() const
+{
+    return height;
+}  // end getHeight
+
+template<class ItemType>
+void BinaryNode<ItemType>::setHeight(int newHeight)
+{
+    height = newHeight;
+}  // end setHeight
+
+template<class ItemType>
+int BinaryNode<ItemType>::getSize() const
+{
+    return size;
+}  // end getSize
+
+template<class ItemType>
+void BinaryNode<ItemType>::setSize(int newSize)
+{
+    size = newSize;
+}  // end setSize
+
+template<class ItemType>
+void BinaryNode<ItemType>::updateAugmentation()
+{
+    int leftHeight = (leftChildPtr == nullptr) ? 0 : leftChildPtr->height;
+    int rightHeight = (rightChildPtr == nullptr) ? 0 : rightChildPtr->height;
+    height = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+    size = 1 + ((leftChildPtr == nullptr) ? 0 : leftChildPtr->size)
+             + ((rightChildPtr == nullptr) ? 0 : rightChildPtr->size);
+}  // end updateAugmentation
+
 template<class ItemType>
 bool BinaryNode<ItemType>::isLeaf() const
 {
@@ -81,25 +187,37 @@ bool BinaryNode<ItemType>::isLeaf() const
 template<class ItemType>
 void BinaryNode<ItemType>::setLeftChildPtr(std::shared_ptr<BinaryNode<ItemType>> leftPtr)
 {
-    leftChildPtr = leftPtr;
+    leftChildPtr = std::move(leftPtr);
 }  // end setLeftChildPtr
 
 template<class ItemType>
 void BinaryNode<ItemType>::setRightChildPtr(std::shared_ptr<BinaryNode<ItemType>> rightPtr)
 {
-    rightChildPtr = rightPtr;
+    rightChildPtr = std::move(rightPtr);
 }  // end setRightChildPtr
 
 template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinaryNode<ItemType>::getLeftChildPtr() const
+const std::shared_ptr<BinaryNode<ItemType>>& BinaryNode<ItemType>::getLeftChildPtr() const
 {
     return leftChildPtr;
 }  // end getLeftChildPtr
 
 template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinaryNode<ItemType>::getRightChildPtr() const
+const std::shared_ptr<BinaryNode<ItemType>>& BinaryNode<ItemType>::getRightChildPtr() const
 {
     return rightChildPtr;
 }  // end getRightChildPtr
 
+template<class ItemType>
+std::shared_ptr<BinaryNode<ItemType>>& BinaryNode<ItemType>::leftChildLink()
+{
+    return leftChildPtr;
+}  // end leftChildLink
+
+template<class ItemType>
+std::shared_ptr<BinaryNode<ItemType>>& BinaryNode<ItemType>::rightChildLink()
+{
+    return rightChildPtr;
+}  // end rightChildLink
+
 #endif //LAB_6_BST_BINARYNODE_H
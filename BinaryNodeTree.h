@@ -10,8 +10,16 @@
 
 #include <memory>
 #include <iostream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
 #include "BinaryTreeInterface.h"
 #include "BinaryNode.h"
+#include "TraversalCursor.h"
+#include "TreeStats.h"
 #include "PrecondViolatedEcxcep.h"
 #include "NotFoundException.h"
 
@@ -20,17 +28,25 @@ class BinaryNodeTree : public BinaryTreeInterface<ItemType>
 {
 protected:
     std::shared_ptr<BinaryNode<ItemType>> rootPtr;
+#if defined(BINARY_TREE_STATS)
+    mutable TreeStatsCounters treeStats;
+#endif
 
 protected:
     //------------------------------------------------------------
     // Protected Utility Methods Section:
-    // Recursive helper methods for the public methods.
+    // Helper methods for the public methods. They walk the tree with
+    // loops and explicit stacks, so a deep (degenerate) tree never
+    // exhausts the call stack.
     //------------------------------------------------------------
 
-    int getHeightHelper(std::shared_ptr<BinaryNode<ItemType>> subTreePtr) const;
-    int getNumberOfNodesHelper(std::shared_ptr<BinaryNode<ItemType>> subTreePtr) const;
+    // Read the height (number of nodes) stored in the subtree's root; 0 for
+    // an empty subtree. Every method that changes the shape of the tree keeps
+    // these fields current, so both run in constant time.
+    int getHeightHelper(const std::shared_ptr<BinaryNode<ItemType>>& subTreePtr) const;
+    int getNumberOfNodesHelper(const std::shared_ptr<BinaryNode<ItemType>>& subTreePtr) const;
 
-    // Recursively adds a new node to the tree in a left/right fashion to
+    // Adds a new node to the tree in a left/right fashion to
     // keep the tree balanced.
     std::shared_ptr<BinaryNode<ItemType>> balancedAdd(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
                                                       std::shared_ptr<BinaryNode<ItemType>> newNodePtr);
@@ -46,23 +62,60 @@ protected:
     removeValue(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
                 const ItemType& target, bool& success);
 
-    // Recursively searches for target value in the tree by using a
+    // Searches for target value in the tree by using a
     // preorder traversal.
-    std::shared_ptr<BinaryNode<ItemType>> findNode(std::shared_ptr<BinaryNode<ItemType>> treePtr,
+    std::shared_ptr<BinaryNode<ItemType>> findNode(const std::shared_ptr<BinaryNode<ItemType>>& treePtr,
                                                    const ItemType& target,
                                                    bool& success) const;
 
     // Copies the tree rooted at treePtr and returns a pointer to
     // the copy.
-    std::shared_ptr<BinaryNode<ItemType>> copyTree(const std::shared_ptr<BinaryNode<ItemType>> oldTreeRootPtr) const;
-
-    // Recursively deletes all nodes from the tree.
-    void destroyTree(std::shared_ptr<BinaryNode<ItemType>> subTreePtr);
-
-    // Recursive traversal helper methods:
-    void preorder(void visit(ItemType&), std::shared_ptr<BinaryNode<ItemType>> treePtr) const;
-    void inorder(void visit(ItemType&), std::shared_ptr<BinaryNode<ItemType>> treePtr) const;
-    void postorder(void visit(ItemType&), std::shared_ptr<BinaryNode<ItemType>> treePtr) const;
+    std::shared_ptr<BinaryNode<ItemType>> copyTree(const std::shared_ptr<BinaryNode<ItemType>>& oldTreeRootPtr) const;
+
+    // Deletes all nodes from the tree held by subTreePtr, one node at a
+    // time, and leaves subTreePtr empty. Nodes that are still shared with
+    // another owner are left intact. It allocates nothing, so the
+    // destructor and the noexcept move assignment can call it.
+    void destroyTree(std::shared_ptr<BinaryNode<ItemType>>& subTreePtr) noexcept;
+
+    // Traversal skeletons: call nodeAction once for each node of the
+    // tree rooted at treePtr, in preorder (inorder, postorder).
+    template<class NodeAction>
+    void preorderNodes(BinaryNode<ItemType>* treePtr, NodeAction nodeAction) const;
+    template<class NodeAction>
+    void inorderNodes(BinaryNode<ItemType>* treePtr, NodeAction nodeAction) const;
+    template<class NodeAction>
+    void postorderNodes(BinaryNode<ItemType>* treePtr, NodeAction nodeAction) const;
+
+    // Calls nodeAction, in inorder, on the count nodes whose inorder
+    // positions start at firstRank. The subtree sizes lead straight to the
+    // first of them, so this costs O(height + count).
+    template<class NodeAction>
+    void inorderRange(int firstRank, int count, NodeAction nodeAction) const;
+
+    // Number of rank ranges a parallel traversal on threadCount threads
+    // cuts the tree into (0 means one thread per hardware thread). There
+    // are several per thread, so a thread that finishes early takes work
+    // that would otherwise wait for a slow one.
+    int rangeTaskCount(int threadCount) const;
+
+    // Cuts the inorder sequence into rangeTaskCount(threadCount) consecutive
+    // rank ranges of nearly equal size and calls
+    // rangeTask(taskIndex, firstRank, count) once for each, on
+    // min(threadCount, number of ranges) threads, the calling one included.
+    // Threads take the next range as they finish one. An exception thrown
+    // by a task is rethrown here once every thread has stopped.
+    template<class RangeTask>
+    void runRangeTasks(int threadCount, RangeTask rangeTask) const;
+
+    // The counters a StatsProbe should add to; nullptr when statistics
+    // are compiled out.
+    TreeStatsCounters* statsCounters() const;
+
+    // Traversal helper methods:
+    void preorder(void visit(ItemType&), const std::shared_ptr<BinaryNode<ItemType>>& treePtr) const;
+    void inorder(void visit(ItemType&), const std::shared_ptr<BinaryNode<ItemType>>& treePtr) const;
+    void postorder(void visit(ItemType&), const std::shared_ptr<BinaryNode<ItemType>>& treePtr) const;
 
 public:
     //------------------------------------------------------------
@@ -74,6 +127,9 @@ public:
                    const std::shared_ptr<BinaryNodeTree<ItemType>> leftTreePtr,
                    const std::shared_ptr<BinaryNodeTree<ItemType>> rightTreePtr);
     BinaryNodeTree(const BinaryNodeTree<ItemType>& tree);
+
+    // Takes over the nodes of tree in O(1) time and leaves it empty.
+    BinaryNodeTree(BinaryNodeTree<ItemType>&& tree) noexcept;
     virtual ~BinaryNodeTree();
 
     //------------------------------------------------------------
@@ -85,22 +141,93 @@ public:
     ItemType getRootData() const throw(PrecondViolatedExcep);
     void setRootData(const ItemType& newData);
     bool add(const ItemType& newData); // Adds a node
+    bool add(ItemType&& newData);      // Adds a node, moving newData into it
+
+    // Adds a node whose item is constructed in place from args.
+    template<class... Args>
+    bool emplace(Args&&... args);
     bool remove(const ItemType& data); // Removes a node
     void clear();
     ItemType getEntry(const ItemType& anEntry) const ;
     bool contains(const ItemType& anEntry) const;
 
+    /** Locates an entry without copying it.
+     @param anEntry  The entry to locate.
+     @return  A pointer to the stored entry that matches anEntry, or nullptr
+        if there is none. The pointer stays valid until that entry is removed
+        or the tree is cleared. */
+    virtual const ItemType* findEntry(const ItemType& anEntry) const;
+
     //------------------------------------------------------------
     // Public Traversals Section.
     //------------------------------------------------------------
+    // The visit function receives a copy of each item, which it may modify
+    // without affecting the tree.
     void preorderTraverse(void visit(ItemType&)) const;
     void inorderTraverse(void visit(ItemType&)) const;
     void postorderTraverse(void visit(ItemType&)) const;
 
+    // visit may be any callable that accepts a const ItemType&, such as a
+    // lambda that accumulates into its captures. It receives a const
+    // reference to each stored item; no item is copied, and the call is
+    // inlined into the traversal loop. A visitor taking ItemType& goes to
+    // the overloads above instead.
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void preorderTraverse(Visitor visit) const;
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void inorderTraverse(Visitor visit) const;
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void postorderTraverse(Visitor visit) const;
+
+    // Lazy traversals: the cursor hands out one item per next() call and
+    // uses O(height) memory, so a scan that stops early only pays for what
+    // it read. Any change to the tree invalidates open cursors.
+    TraversalCursor<ItemType> preorderCursor() const;
+    TraversalCursor<ItemType> inorderCursor() const;
+    TraversalCursor<ItemType> postorderCursor() const;
+
+    //------------------------------------------------------------
+    // Parallel Traversals Section.
+    // The tree is cut into ranges of consecutive inorder positions, which
+    // threads then walk at the same time. The tree must not change while
+    // they run. threadCount 0 means one thread per hardware thread. A tree
+    // too small to give every thread a range runs on fewer threads, one
+    // per range, since the spare threads would have nothing to do.
+    //------------------------------------------------------------
+    /** Calls visit once for each stored item, from several threads at
+        once and in no particular order. */
+    template<class Visitor>
+    void parallelForEach(Visitor visit, int threadCount = 0) const;
+
+    /** Folds the items into one result in parallel. Each range is folded
+        left to right with result = accumulate(result, item), starting from
+        identity, and the range results are then merged in inorder with
+        combine(left, right). The merge keeps the inorder sequence, so
+        combine needs to be associative but not commutative.
+     @return  The combined result, or identity for an empty tree. */
+    template<class ResultType, class Accumulate, class Combine>
+    ResultType parallelReduce(const ResultType& identity, Accumulate accumulate, Combine combine,
+                              int threadCount = 0) const;
+
+    //------------------------------------------------------------
+    // Statistics Section.
+    // The counters exist only when BINARY_TREE_STATS is defined; see
+    // TreeStats.h. Otherwise getStats() returns zeros.
+    //------------------------------------------------------------
+    /** @return  A copy of the counters since the last resetStats(). */
+    TreeStats getStats() const;
+
+    /** Sets every counter of this tree back to zero. */
+    void resetStats();
+
     //------------------------------------------------------------
     // Overloaded Operator Section.
     //------------------------------------------------------------
     BinaryNodeTree& operator=(const BinaryNodeTree& rightHandSide);
+
+    // Releases this tree's nodes and takes over those of rightHandSide,
+    // which is left empty.
+    BinaryNodeTree& operator=(BinaryNodeTree&& rightHandSide) noexcept;
 }; // end BinaryNodeTree
 
 
@@ -110,81 +237,71 @@ public:
 //////////////////////////////////////////////////////////////
 
 template<class ItemType>
-int BinaryNodeTree<ItemType>::getHeightHelper(std::shared_ptr<BinaryNode<ItemType>> subTreePtr) const
+int BinaryNodeTree<ItemType>::getHeightHelper(const std::shared_ptr<BinaryNode<ItemType>>& subTreePtr) const
 {
-    if (subTreePtr == nullptr)
-        return 0;
-    else
-        return 1 + std::max(getHeightHelper(subTreePtr->getLeftChildPtr()),
-                            getHeightHelper(subTreePtr->getRightChildPtr()));
+    return (subTreePtr == nullptr) ? 0 : subTreePtr->getHeight();
 }  // end getHeightHelper
 
 template<class ItemType>
-int BinaryNodeTree<ItemType>::getNumberOfNodesHelper(std::shared_ptr<BinaryNode<ItemType>> subTreePtr) const
+int BinaryNodeTree<ItemType>::getNumberOfNodesHelper(const std::shared_ptr<BinaryNode<ItemType>>& subTreePtr) const
 {
-    if (subTreePtr == nullptr)
-        return 0;
-    else
-        return 1 + getNumberOfNodesHelper(subTreePtr->getLeftChildPtr())
-               + getNumberOfNodesHelper(subTreePtr->getRightChildPtr());
+    return (subTreePtr == nullptr) ? 0 : subTreePtr->getSize();
 }  // end getNumberOfNodesHelper
 
 template<class ItemType>
 std::shared_ptr<BinaryNode<ItemType>> BinaryNodeTree<ItemType>::balancedAdd(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
                                                                             std::shared_ptr<BinaryNode<ItemType>> newNodePtr)
 {
-    if (subTreePtr == nullptr)
-        return newNodePtr;
-    else
+    // Follow the shorter side down to the empty link where the new node belongs
+    std::vector<BinaryNode<ItemType>*> path;
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreePtr;
+    while (*link != nullptr)
     {
-        auto leftPtr = subTreePtr->getLeftChildPtr();
-        auto rightPtr = subTreePtr->getRightChildPtr();
-
-        if (getHeightHelper(leftPtr) > getHeightHelper(rightPtr))
-        {
-            rightPtr = balancedAdd(rightPtr , newNodePtr);
-            subTreePtr->setRightChildPtr(rightPtr );
-        }
+        BinaryNode<ItemType>* nodePtr = link->get();
+        path.push_back(nodePtr);
+        if (getHeightHelper(nodePtr->getLeftChildPtr()) > getHeightHelper(nodePtr->getRightChildPtr()))
+            link = &nodePtr->rightChildLink();
         else
-        {
-            leftPtr = balancedAdd(leftPtr, newNodePtr);
-            subTreePtr->setLeftChildPtr(leftPtr);
-        }  // end if
+            link = &nodePtr->leftChildLink();
+    }  // end while
 
-        return subTreePtr;
-    }  // end if
+    *link = std::move(newNodePtr);
+    for (auto nodePtr = path.rbegin(); nodePtr != path.rend(); ++nodePtr)
+        (*nodePtr)->updateAugmentation();
+    return subTreePtr;
 }  // end balancedAdd
 
 template<class ItemType>
 std::shared_ptr<BinaryNode<ItemType>> BinaryNodeTree<ItemType>::moveValuesUpTree(std::shared_ptr<BinaryNode<ItemType>> subTreePtr)
 {
-    auto  leftPtr = subTreePtr->getLeftChildPtr();
-    auto  rightPtr = subTreePtr->getRightChildPtr();
-    int leftHeight = getHeightHelper(leftPtr);
-    int rightHeight = getHeightHelper(rightPtr);
-    if (leftHeight > rightHeight)
-    {
-        subTreePtr->setItem(leftPtr->getItem());
-        leftPtr = moveValuesUpTree(leftPtr);
-        subTreePtr->setLeftChildPtr(leftPtr);
-        return subTreePtr;
-    }
-    else
+    std::vector<BinaryNode<ItemType>*> path;
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreePtr;
+    while (true)
     {
-        if (rightPtr != nullptr)
+        BinaryNode<ItemType>* nodePtr = link->get();
+        const auto& leftPtr = nodePtr->getLeftChildPtr();
+        const auto& rightPtr = nodePtr->getRightChildPtr();
+        if (getHeightHelper(leftPtr) > getHeightHelper(rightPtr))
         {
-            subTreePtr->setItem(rightPtr->getItem());
-            rightPtr =moveValuesUpTree(rightPtr);
-            subTreePtr->setRightChildPtr(rightPtr);
-            return subTreePtr;
+            nodePtr->setItem(leftPtr->takeItem());
+            link = &nodePtr->leftChildLink();
+        }
+        else if (rightPtr != nullptr)
+        {
+            nodePtr->setItem(rightPtr->takeItem());
+            link = &nodePtr->rightChildLink();
         }
         else
         {
             //this was a leaf!
-            // value not important
-            return nullptr;
+            // its value now lives in its parent
+            link->reset();
+            for (auto pathPtr = path.rbegin(); pathPtr != path.rend(); ++pathPtr)
+                (*pathPtr)->updateAugmentation();
+            return subTreePtr;
         }  // end if
-    }  // end if
+        path.push_back(nodePtr);
+    }  // end while
 }  // end moveValuesUpTree
 
 /** Depth-first search of tree for item.
@@ -197,121 +314,354 @@ std::shared_ptr<BinaryNode<ItemType>> BinaryNodeTree<ItemType>::removeValue(std:
                                                                             const ItemType& target,
                                                                             bool& success)
 {
-    if(subTreePtr == nullptr) // not found here
-        return subTreePtr;
-
-    if (subTreePtr->getItem() == target) // found it
+    // Preorder search over the links, so the matching node can be replaced in
+    // its parent; each entry records its depth so the ancestors are known
+    std::vector<std::pair<std::shared_ptr<BinaryNode<ItemType>>*, std::size_t>> linkStack;
+    std::vector<BinaryNode<ItemType>*> ancestors;
+    StatsProbe probe(statsCounters(), true);
+    linkStack.emplace_back(&subTreePtr, 0);
+    while (!linkStack.empty())
     {
-        subTreePtr = moveValuesUpTree(subTreePtr);
-        success = true;
-        return subTreePtr;
-    }
-    else
-    {
-        auto targetNodePtr = removeValue(subTreePtr->getLeftChildPtr(), target, success);
-        subTreePtr->setLeftChildPtr(targetNodePtr);
-        if (!success) // no need to search right subTree
+        std::shared_ptr<BinaryNode<ItemType>>* link = linkStack.back().first;
+        std::size_t depth = linkStack.back().second;
+        linkStack.pop_back();
+        if (*link == nullptr) // not found here
+            continue;
+
+        ancestors.resize(depth);
+        probe.visited();
+        probe.compared();
+        if ((*link)->getItem() == target) // found it
         {
-            targetNodePtr = removeValue(subTreePtr->getRightChildPtr(), target, success);
-            subTreePtr->setRightChildPtr(targetNodePtr);
+            *link = moveValuesUpTree(*link);
+            for (auto nodePtr = ancestors.rbegin(); nodePtr != ancestors.rend(); ++nodePtr)
+                (*nodePtr)->updateAugmentation();
+            success = true;
+            return subTreePtr;
         }  // end if
 
-        return subTreePtr;
-    }  // end if
+        ancestors.push_back(link->get());
+        linkStack.emplace_back(&(*link)->rightChildLink(), depth + 1);
+        linkStack.emplace_back(&(*link)->leftChildLink(), depth + 1);
+    }  // end while
+
+    return subTreePtr;
 }  // end removeValue
 
 template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinaryNodeTree<ItemType>::findNode(std::shared_ptr<BinaryNode<ItemType>> treePtr,
+std::shared_ptr<BinaryNode<ItemType>> BinaryNodeTree<ItemType>::findNode(const std::shared_ptr<BinaryNode<ItemType>>& treePtr,
                                                                          const ItemType& target,
                                                                          bool& success) const
 {
-    if (treePtr == nullptr) // not found here
-        return treePtr;
-
-    if (treePtr->getItem() == target) // found it
+    std::vector<const std::shared_ptr<BinaryNode<ItemType>>*> linkStack;
+    StatsProbe probe(statsCounters(), true);
+    linkStack.push_back(&treePtr);
+    while (!linkStack.empty())
     {
-        success = true;
-        return treePtr;
-    }
-    else
-    {
-        std::shared_ptr<BinaryNode<ItemType>> targetNodePtr = findNode(treePtr->getLeftChildPtr(), target, success);
-        if (!success) // no need to search right subTree
+        const std::shared_ptr<BinaryNode<ItemType>>* link = linkStack.back();
+        linkStack.pop_back();
+        if (*link == nullptr) // not found here
+            continue;
+
+        probe.visited();
+        probe.compared();
+        if ((*link)->getItem() == target) // found it
         {
-            targetNodePtr = findNode(treePtr->getRightChildPtr(), target, success);
+            success = true;
+            return *link;
         }  // end if
 
-        return targetNodePtr;
-    }  // end if
+        linkStack.push_back(&(*link)->getRightChildPtr());
+        linkStack.push_back(&(*link)->getLeftChildPtr());
+    }  // end while
+
+    return nullptr;
 }  // end findNode
 
 template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinaryNodeTree<ItemType>::copyTree(const std::shared_ptr<BinaryNode<ItemType>> oldTreeRootPtr) const
+std::shared_ptr<BinaryNode<ItemType>> BinaryNodeTree<ItemType>::copyTree(const std::shared_ptr<BinaryNode<ItemType>>& oldTreeRootPtr) const
 {
     std::shared_ptr<BinaryNode<ItemType>> newTreePtr;
 
-    // Copy tree nodes during a preorder traversal
+    // Copy tree nodes during a preorder traversal; each stack entry pairs an
+    // original node with the empty link that will hold its copy
+    std::vector<std::pair<BinaryNode<ItemType>*, std::shared_ptr<BinaryNode<ItemType>>*>> copyStack;
     if (oldTreeRootPtr != nullptr)
+        copyStack.emplace_back(oldTreeRootPtr.get(), &newTreePtr);
+
+    while (!copyStack.empty())
     {
+        BinaryNode<ItemType>* oldNodePtr = copyStack.back().first;
+        std::shared_ptr<BinaryNode<ItemType>>& newLink = *copyStack.back().second;
+        copyStack.pop_back();
+
         // Copy node
-        newTreePtr = std::make_shared<BinaryNode<ItemType>>(oldTreeRootPtr->getItem(), nullptr, nullptr);
-        newTreePtr->setLeftChildPtr(copyTree(oldTreeRootPtr->getLeftChildPtr()));
-        newTreePtr->setRightChildPtr(copyTree(oldTreeRootPtr->getRightChildPtr()));
-    }  // end if
+        newLink = std::make_shared<BinaryNode<ItemType>>(oldNodePtr->getItem(), nullptr, nullptr);
+        newLink->setHeight(oldNodePtr->getHeight());
+        newLink->setSize(oldNodePtr->getSize());
+        if (oldNodePtr->getRightChildPtr() != nullptr)
+            copyStack.emplace_back(oldNodePtr->getRightChildPtr().get(), &newLink->rightChildLink());
+        if (oldNodePtr->getLeftChildPtr() != nullptr)
+            copyStack.emplace_back(oldNodePtr->getLeftChildPtr().get(), &newLink->leftChildLink());
+    }  // end while
 
     return newTreePtr;
 }  // end copyTree
 
 template<class ItemType>
-void BinaryNodeTree<ItemType>::destroyTree(std::shared_ptr<BinaryNode<ItemType>> subTreePtr)
+void BinaryNodeTree<ItemType>::destroyTree(std::shared_ptr<BinaryNode<ItemType>>& subTreePtr) noexcept
 {
-    if (subTreePtr != nullptr)
+    // Each node is released only once it has no children, so freeing a deep
+    // tree never recurses through the shared_ptr destructors. Instead of a
+    // stack, the nodes still to free are rotated onto the right spine of
+    // nodePtr: a node with a left child is rotated right, and one without
+    // is released after its right subtree takes its place.
+    std::shared_ptr<BinaryNode<ItemType>> nodePtr = std::move(subTreePtr);
+    while (nodePtr != nullptr)
     {
-        destroyTree(subTreePtr->getLeftChildPtr());
-        destroyTree(subTreePtr->getRightChildPtr());
-        subTreePtr.reset(); // decrement reference count to node
-    }  // end if
+        // Another owner's node is only let go of. Rotated nodes are always
+        // above it on the spine, so all below it is the other owner's too.
+        if (nodePtr.use_count() > 1)
+            nodePtr.reset();
+        else if (nodePtr->getLeftChildPtr() == nullptr)
+        {
+            std::shared_ptr<BinaryNode<ItemType>> rightPtr = std::move(nodePtr->rightChildLink());
+            nodePtr = std::move(rightPtr);
+        }
+        else if (nodePtr->getLeftChildPtr().use_count() > 1)
+            nodePtr->leftChildLink().reset();
+        else
+        {
+            std::shared_ptr<BinaryNode<ItemType>> leftPtr = std::move(nodePtr->leftChildLink());
+            nodePtr->leftChildLink() = std::move(leftPtr->rightChildLink());
+            leftPtr->rightChildLink() = std::move(nodePtr);
+            nodePtr = std::move(leftPtr);
+        }  // end if
+    }  // end while
 }  // end destroyTree
 
+template<class ItemType>
+TreeStatsCounters* BinaryNodeTree<ItemType>::statsCounters() const
+{
+#if defined(BINARY_TREE_STATS)
+    return &treeStats;
+#else
+    return nullptr;
+#endif
+}  // end statsCounters
+
 //////////////////////////////////////////////////////////////
 //      Protected Tree Traversal Sub-Section
 //////////////////////////////////////////////////////////////
 
 template<class ItemType>
-void BinaryNodeTree<ItemType>::preorder(void visit(ItemType&), std::shared_ptr<BinaryNode<ItemType>> treePtr) const
+template<class NodeAction>
+void BinaryNodeTree<ItemType>::preorderNodes(BinaryNode<ItemType>* treePtr, NodeAction nodeAction) const
 {
+    std::vector<BinaryNode<ItemType>*> nodeStack;
+    StatsProbe probe(statsCounters(), false);
     if (treePtr != nullptr)
+        nodeStack.push_back(treePtr);
+
+    while (!nodeStack.empty())
+    {
+        BinaryNode<ItemType>* nodePtr = nodeStack.back();
+        nodeStack.pop_back();
+        probe.visited();
+        nodeAction(nodePtr);
+        if (nodePtr->getRightChildPtr() != nullptr)
+            nodeStack.push_back(nodePtr->getRightChildPtr().get());
+        if (nodePtr->getLeftChildPtr() != nullptr)
+            nodeStack.push_back(nodePtr->getLeftChildPtr().get());
+    }  // end while
+}  // end preorderNodes
+
+template<class ItemType>
+template<class NodeAction>
+void BinaryNodeTree<ItemType>::inorderNodes(BinaryNode<ItemType>* treePtr, NodeAction nodeAction) const
+{
+    std::vector<BinaryNode<ItemType>*> nodeStack;
+    StatsProbe probe(statsCounters(), false);
+    BinaryNode<ItemType>* currentPtr = treePtr;
+    while ((currentPtr != nullptr) || !nodeStack.empty())
+    {
+        // Stack up the left spine, then visit the deepest node and move to its right subtree
+        while (currentPtr != nullptr)
+        {
+            nodeStack.push_back(currentPtr);
+            currentPtr = currentPtr->getLeftChildPtr().get();
+        }  // end while
+
+        currentPtr = nodeStack.back();
+        nodeStack.pop_back();
+        probe.visited();
+        nodeAction(currentPtr);
+        currentPtr = currentPtr->getRightChildPtr().get();
+    }  // end while
+}  // end inorderNodes
+
+template<class ItemType>
+template<class NodeAction>
+void BinaryNodeTree<ItemType>::postorderNodes(BinaryNode<ItemType>* treePtr, NodeAction nodeAction) const
+{
+    std::vector<BinaryNode<ItemType>*> nodeStack;
+    StatsProbe probe(statsCounters(), false);
+    BinaryNode<ItemType>* currentPtr = treePtr;
+    BinaryNode<ItemType>* lastVisitedPtr = nullptr;
+    while ((currentPtr != nullptr) || !nodeStack.empty())
+    {
+        if (currentPtr != nullptr)
+        {
+            nodeStack.push_back(currentPtr);
+            currentPtr = currentPtr->getLeftChildPtr().get();
+        }
+        else
+        {
+            // A node is visited once its right subtree is empty or has just been visited
+            BinaryNode<ItemType>* topPtr = nodeStack.back();
+            BinaryNode<ItemType>* rightPtr = topPtr->getRightChildPtr().get();
+            if ((rightPtr != nullptr) && (rightPtr != lastVisitedPtr))
+            {
+                currentPtr = rightPtr;
+            }
+            else
+            {
+                probe.visited();
+                nodeAction(topPtr);
+                lastVisitedPtr = topPtr;
+                nodeStack.pop_back();
+            }  // end if
+        }  // end if
+    }  // end while
+}  // end postorderNodes
+
+template<class ItemType>
+template<class NodeAction>
+void BinaryNodeTree<ItemType>::inorderRange(int firstRank, int count, NodeAction nodeAction) const
+{
+    // Descend to the node at firstRank, stacking the nodes whose left
+    // subtree the walk enters; they follow it in inorder
+    std::vector<BinaryNode<ItemType>*> nodeStack;
+    BinaryNode<ItemType>* currentPtr = rootPtr.get();
+    while (currentPtr != nullptr)
+    {
+        int leftSize = getNumberOfNodesHelper(currentPtr->getLeftChildPtr());
+        if (firstRank < leftSize)
+        {
+            nodeStack.push_back(currentPtr);
+            currentPtr = currentPtr->getLeftChildPtr().get();
+        }
+        else if (firstRank == leftSize)
+        {
+            nodeStack.push_back(currentPtr);
+            break;
+        }
+        else
+        {
+            firstRank -= leftSize + 1;
+            currentPtr = currentPtr->getRightChildPtr().get();
+        }  // end if
+    }  // end while
+
+    // Then continue an ordinary inorder walk for count nodes
+    StatsProbe probe(statsCounters(), false);
+    for (; (count > 0) && !nodeStack.empty(); count--)
+    {
+        currentPtr = nodeStack.back();
+        nodeStack.pop_back();
+        probe.visited();
+        nodeAction(currentPtr);
+        for (currentPtr = currentPtr->getRightChildPtr().get(); currentPtr != nullptr;
+             currentPtr = currentPtr->getLeftChildPtr().get())
+            nodeStack.push_back(currentPtr);
+    }  // end for
+}  // end inorderRange
+
+template<class ItemType>
+int BinaryNodeTree<ItemType>::rangeTaskCount(int threadCount) const
+{
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    return std::min(getNumberOfNodes(), 8 * threadCount);
+}  // end rangeTaskCount
+
+template<class ItemType>
+template<class RangeTask>
+void BinaryNodeTree<ItemType>::runRangeTasks(int threadCount, RangeTask rangeTask) const
+{
+    int numberOfNodes = getNumberOfNodes();
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int taskCount = rangeTaskCount(threadCount);
+    threadCount = std::min(threadCount, taskCount);  // a thread without a range would only idle
+    std::atomic<int> nextTask(0);
+    auto worker = [&]()
+    {
+        for (int task = nextTask++; task < taskCount; task = nextTask++)
+        {
+            long firstRank = static_cast<long>(numberOfNodes) * task / taskCount;
+            long lastRank = static_cast<long>(numberOfNodes) * (task + 1) / taskCount;
+            rangeTask(task, static_cast<int>(firstRank), static_cast<int>(lastRank - firstRank));
+        }  // end for
+    };
+
+    // The calling thread is one of the workers
+    std::vector<std::future<void>> helpers;
+    for (int thread = 1; thread < threadCount; thread++)
+        helpers.push_back(std::async(std::launch::async, worker));
+    std::exception_ptr firstError;
+    try
     {
-        ItemType theItem = treePtr->getItem();
+        worker();
+    }
+    catch (...)
+    {
+        firstError = std::current_exception();
+    }  // end try
+    for (auto& helper : helpers)
+    {
+        try
+        {
+            helper.get();
+        }
+        catch (...)
+        {
+            if (!firstError)
+                firstError = std::current_exception();
+        }  // end try
+    }  // end for
+    if (firstError)
+        std::rethrow_exception(firstError);
+}  // end runRangeTasks
+
+template<class ItemType>
+void BinaryNodeTree<ItemType>::preorder(void visit(ItemType&), const std::shared_ptr<BinaryNode<ItemType>>& treePtr) const
+{
+    preorderNodes(treePtr.get(), [visit](BinaryNode<ItemType>* nodePtr)
+    {
+        ItemType theItem = nodePtr->getItem();
         visit(theItem);
-//      visit(treePtr->getItem());
-        preorder(visit, treePtr->getLeftChildPtr());
-        preorder(visit, treePtr->getRightChildPtr());
-    }  // end if
+    });
 }  // end preorder
 
 template<class ItemType>
-void BinaryNodeTree<ItemType>::inorder(void visit(ItemType&), std::shared_ptr<BinaryNode<ItemType>> treePtr) const
+void BinaryNodeTree<ItemType>::inorder(void visit(ItemType&), const std::shared_ptr<BinaryNode<ItemType>>& treePtr) const
 {
-    if (treePtr != nullptr)
+    inorderNodes(treePtr.get(), [visit](BinaryNode<ItemType>* nodePtr)
     {
-        inorder(visit, treePtr->getLeftChildPtr());
-        ItemType theItem = treePtr->getItem();
+        ItemType theItem = nodePtr->getItem();
         visit(theItem);
-        inorder(visit, treePtr->getRightChildPtr());
-    }  // end if
+    });
 }  // end inorder
 
 template<class ItemType>
-void BinaryNodeTree<ItemType>::postorder(void visit(ItemType&), std::shared_ptr<BinaryNode<ItemType>> treePtr) const
+void BinaryNodeTree<ItemType>::postorder(void visit(ItemType&), const std::shared_ptr<BinaryNode<ItemType>>& treePtr) const
 {
-    if (treePtr != nullptr)
+    postorderNodes(treePtr.get(), [visit](BinaryNode<ItemType>* nodePtr)
     {
-        postorder(visit, treePtr->getLeftChildPtr());
-        postorder(visit, treePtr->getRightChildPtr());
-        ItemType theItem = treePtr->getItem();
+        ItemType theItem = nodePtr->getItem();
         visit(theItem);
-    } // end if
+    });
 }  // end postorder
 
 //////////////////////////////////////////////////////////////
@@ -346,6 +696,11 @@ BinaryNodeTree<ItemType>::BinaryNodeTree(const BinaryNodeTree<ItemType>& treePtr
     rootPtr = copyTree(treePtr.rootPtr);
 }  // end copy constructor
 
+template<class ItemType>
+BinaryNodeTree<ItemType>::BinaryNodeTree(BinaryNodeTree<ItemType>&& tree) noexcept
+        :rootPtr(std::move(tree.rootPtr))
+{  }  // end move constructor
+
 template<class ItemType>
 BinaryNodeTree<ItemType>::~BinaryNodeTree()
 {
@@ -379,7 +734,6 @@ template<class ItemType>
 void BinaryNodeTree<ItemType>::clear()
 {
     destroyTree(rootPtr);
-    rootPtr.reset();
 }  // end clear
 
 template<class ItemType>
@@ -404,10 +758,27 @@ template<class ItemType>
 bool BinaryNodeTree<ItemType>::add(const ItemType& newData)
 {
     auto newNodePtr = std::make_shared<BinaryNode<ItemType>>(newData);
-    rootPtr = balancedAdd(rootPtr, newNodePtr);
+    rootPtr = balancedAdd(std::move(rootPtr), std::move(newNodePtr));
     return true;
 }  // end add
 
+template<class ItemType>
+bool BinaryNodeTree<ItemType>::add(ItemType&& newData)
+{
+    auto newNodePtr = std::make_shared<BinaryNode<ItemType>>(std::move(newData));
+    rootPtr = balancedAdd(std::move(rootPtr), std::move(newNodePtr));
+    return true;
+}  // end add
+
+template<class ItemType>
+template<class... Args>
+bool BinaryNodeTree<ItemType>::emplace(Args&&... args)
+{
+    auto newNodePtr = std::make_shared<BinaryNode<ItemType>>(IN_PLACE_ITEM, std::forward<Args>(args)...);
+    rootPtr = balancedAdd(std::move(rootPtr), std::move(newNodePtr));
+    return true;
+}  // end emplace
+
 template<class ItemType>
 bool BinaryNodeTree<ItemType>::remove(const ItemType& target)
 {
@@ -436,6 +807,14 @@ bool BinaryNodeTree<ItemType>:: contains(const ItemType& anEntry) const
     return isSuccessful;
 }  // end contains
 
+template<class ItemType>
+const ItemType* BinaryNodeTree<ItemType>::findEntry(const ItemType& anEntry) const
+{
+    bool isSuccessful = false;
+    auto binaryNodePtr = findNode(rootPtr, anEntry, isSuccessful);
+    return isSuccessful ? &binaryNodePtr->getItem() : nullptr;
+}  // end findEntry
+
 //////////////////////////////////////////////////////////////
 //      Public Traversals Section
 //////////////////////////////////////////////////////////////
@@ -458,6 +837,105 @@ void BinaryNodeTree<ItemType>::postorderTraverse(void visit(ItemType&)) const
     postorder(visit, rootPtr);
 }  // end postorderTraverse
 
+template<class ItemType>
+template<class Visitor, class>
+void BinaryNodeTree<ItemType>::preorderTraverse(Visitor visit) const
+{
+    preorderNodes(rootPtr.get(), [&visit](BinaryNode<ItemType>* nodePtr) { visit(nodePtr->getItem()); });
+}  // end preorderTraverse
+
+template<class ItemType>
+template<class Visitor, class>
+void BinaryNodeTree<ItemType>::inorderTraverse(Visitor visit) const
+{
+    inorderNodes(rootPtr.get(), [&visit](BinaryNode<ItemType>* nodePtr) { visit(nodePtr->getItem()); });
+}  // end inorderTraverse
+
+template<class ItemType>
+template<class Visitor, class>
+void BinaryNodeTree<ItemType>::postorderTraverse(Visitor visit) const
+{
+    postorderNodes(rootPtr.get(), [&visit](BinaryNode<ItemType>* nodePtr) { visit(nodePtr->getItem()); });
+}  // end postorderTraverse
+
+template<class ItemType>
+TraversalCursor<ItemType> BinaryNodeTree<ItemType>::preorderCursor() const
+{
+    return TraversalCursor<ItemType>(rootPtr.get(), TraversalOrder::PREORDER);
+}  // end preorderCursor
+
+template<class ItemType>
+TraversalCursor<ItemType> BinaryNodeTree<ItemType>::inorderCursor() const
+{
+    return TraversalCursor<ItemType>(rootPtr.get(), TraversalOrder::INORDER);
+}  // end inorderCursor
+
+template<class ItemType>
+TraversalCursor<ItemType> BinaryNodeTree<ItemType>::postorderCursor() const
+{
+    return TraversalCursor<ItemType>(rootPtr.get(), TraversalOrder::POSTORDER);
+}  // end postorderCursor
+
+//////////////////////////////////////////////////////////////
+//      Parallel Traversals Section
+//////////////////////////////////////////////////////////////
+
+template<class ItemType>
+template<class Visitor>
+void BinaryNodeTree<ItemType>::parallelForEach(Visitor visit, int threadCount) const
+{
+    runRangeTasks(threadCount, [this, &visit](int, int firstRank, int count)
+    {
+        inorderRange(firstRank, count, [&visit](BinaryNode<ItemType>* nodePtr) { visit(nodePtr->getItem()); });
+    });
+}  // end parallelForEach
+
+template<class ItemType>
+template<class ResultType, class Accumulate, class Combine>
+ResultType BinaryNodeTree<ItemType>::parallelReduce(const ResultType& identity, Accumulate accumulate,
+                                                    Combine combine, int threadCount) const
+{
+    // Each range folds into its own slot; the slots are merged in order afterwards
+    int taskCount = rangeTaskCount(threadCount);
+    std::vector<ResultType> rangeResults(taskCount, identity);
+    runRangeTasks(threadCount, [this, &identity, &accumulate, &rangeResults](int task, int firstRank, int count)
+    {
+        ResultType result = identity;
+        inorderRange(firstRank, count, [&result, &accumulate](BinaryNode<ItemType>* nodePtr)
+        {
+            result = accumulate(std::move(result), nodePtr->getItem());
+        });
+        rangeResults[task] = std::move(result);
+    });
+
+    ResultType result = identity;
+    for (int task = 0; task < taskCount; task++)
+        result = combine(std::move(result), std::move(rangeResults[task]));
+    return result;
+}  // end parallelReduce
+
+//////////////////////////////////////////////////////////////
+//      Statistics Section
+//////////////////////////////////////////////////////////////
+
+template<class ItemType>
+TreeStats BinaryNodeTree<ItemType>::getStats() const
+{
+#if defined(BINARY_TREE_STATS)
+    return treeStats.snapshot();
+#else
+    return TreeStats();
+#endif
+}  // end getStats
+
+template<class ItemType>
+void BinaryNodeTree<ItemType>::resetStats()
+{
+#if defined(BINARY_TREE_STATS)
+    treeStats.reset();
+#endif
+}  // end resetStats
+
 //////////////////////////////////////////////////////////////
 //      Overloaded Operator
 //////////////////////////////////////////////////////////////
@@ -466,9 +944,25 @@ template<class ItemType>
 BinaryNodeTree<ItemType>& BinaryNodeTree<ItemType>::operator=(
         const BinaryNodeTree<ItemType>& rightHandSide)
 {
-    if (!isEmpty())
-        clear();
-    this = copyTree(&rightHandSide);
+    if (this != &rightHandSide)
+    {
+        // Copy first, so a failed copy leaves this tree as it was
+        std::shared_ptr<BinaryNode<ItemType>> newRootPtr = copyTree(rightHandSide.rootPtr);
+        destroyTree(rootPtr);
+        rootPtr = std::move(newRootPtr);
+    }  // end if
+    return *this;
+}  // end operator=
+
+template<class ItemType>
+BinaryNodeTree<ItemType>& BinaryNodeTree<ItemType>::operator=(
+        BinaryNodeTree<ItemType>&& rightHandSide) noexcept
+{
+    if (this != &rightHandSide)
+    {
+        destroyTree(rootPtr);
+        rootPtr = std::move(rightHandSide.rootPtr);
+    }  // end if
     return *this;
 }  // end operator=
 
@@ -9,23 +9,83 @@
 
 #include <memory>
 #include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
 #include "BinaryTreeInterface.h"
 #include "BinaryNode.h"
 #include "BinaryNodeTree.h"
+#include "TraversalCursor.h"
+#include "TreeOrder.h"
 #include "NotFoundException.h"
 #include "PrecondViolatedEcxcep.h"
 
-template<class ItemType>
+template<class ItemType, class Compare = DefaultOrder<ItemType>>
+class FrozenSearchTree;
+
+template<class ItemType, class Compare = DefaultOrder<ItemType>>
 class BinarySearchTree : public BinaryNodeTree<ItemType>
 {
 // use this->rootPtr to access the BinaryNodeTree rootPtr
+// Entries are ordered by Compare; see TreeOrder.h. The default orders
+// them with ItemType's > and == operators.
+
+public:
+    // Bidirectional iterator over the entries in sorted order. It keeps
+    // the path of nodes from the root down to its entry, so it needs no
+    // parent pointers, and ++ and -- take O(1) amortized time. Entries
+    // cannot be changed through it, since that could break the ordering.
+    // Any add, remove or clear invalidates every iterator.
+    class const_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef ItemType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const ItemType* pointer;
+        typedef const ItemType& reference;
+
+        const_iterator();
+
+        reference operator*() const;
+        pointer operator->() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        // Decrementing end() moves to the largest entry.
+        const_iterator& operator--();
+        const_iterator operator--(int);
+        bool operator==(const const_iterator& rightHandSide) const;
+        bool operator!=(const const_iterator& rightHandSide) const;
+
+    private:
+        friend class BinarySearchTree<ItemType, Compare>;
+
+        explicit const_iterator(const BinarySearchTree<ItemType, Compare>* aTreePtr);
+
+        const BinarySearchTree<ItemType, Compare>* treePtr;
+        // The root comes first and the current node last; empty at end().
+        std::vector<BinaryNode<ItemType>*> path;
+    };
+    typedef const_iterator iterator;
 
 protected:
+    Compare comparator;
+
+    // Three-way comparison under the tree's ordering: negative if leftItem
+    // comes first, positive if rightItem does, zero if they are equivalent.
+    // Either argument may be a key of another type that the ordering accepts.
+    template<class Left, class Right>
+    int compareItems(const Left& leftItem, const Right& rightItem) const;
+
+    // A path is the sequence of links followed from a subtree root down to
+    // the place where the tree changed.
+    typedef std::vector<std::shared_ptr<BinaryNode<ItemType>>*> LinkPath;
+
     //------------------------------------------------------------
     // Protected Utility Methods Section:
-    // Recursive helper methods for the public methods.
+    // Iterative helper methods for the public methods.
     //------------------------------------------------------------
-    // Recursively finds where the given node should be placed and
+    // Finds where the given node should be placed and
     // inserts it in a leaf at that point.
     std::shared_ptr<BinaryNode<ItemType>> placeNode(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
                                                     std::shared_ptr<BinaryNode<ItemType>> newNode);
@@ -42,30 +102,336 @@ protected:
 
     // Removes the leftmost node in the left subtree of the node
     // pointed to by nodePtr.
-    // Sets inorderSuccessor to the value in this node.
+    // Moves the value in this node into inorderSuccessor.
     // Returns a pointer to the revised subtree.
     std::shared_ptr<BinaryNode<ItemType>> removeLeftmostNode(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
                                                              ItemType& inorderSuccessor);
 
     // Returns a pointer to the node containing the given value,
     // or nullptr if not found.
-    std::shared_ptr<BinaryNode<ItemType>> findNode(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
-                                                   const ItemType& target) const;
+    template<class Key>
+    std::shared_ptr<BinaryNode<ItemType>> findNode(const std::shared_ptr<BinaryNode<ItemType>>& subTreePtr,
+                                                   const Key& target) const;
+
+    // Called for every link on the path of an add or remove, deepest first,
+    // after the subtree held by subTreeLink has changed shape. The plain tree
+    // refreshes the node's height and size; derived trees override it to
+    // rebalance as well.
+    virtual void fixUpLink(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink);
+
+    // Calls fixUpLink on each link of the path, from the bottom up.
+    void fixUpPath(const LinkPath& path);
+
+    // Called for every link whose node an add or remove is about to change,
+    // before the change and before the walk moves below that node. The
+    // plain tree changes its nodes in place, so this does nothing; a tree
+    // whose nodes may be shared with another version overrides it to put a
+    // private copy of the node in the link.
+    virtual void detachLink(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink);
+
+    // True for a tree whose nodes may be shared with other versions, whose
+    // detachLink therefore copies them. The plain tree returns false.
+    virtual bool sharesNodes() const;
+
+    // Calls detachLink on every link of the subtree held by subTreeLink,
+    // parents before children, so that none of its nodes is shared with
+    // another version afterwards. O(n); used when nodes move from a tree
+    // that shares them into one that does not.
+    void detachAllLinks(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink);
+
+    // Builds a tree of minimum height from the itemCount sorted items that
+    // start at sortedFirst and returns its root. Each node's item is made
+    // from *(sortedFirst + index), so a move_iterator moves the items in.
+    // Each subtree root is the middle item of its range, so every node's
+    // subtrees differ in size by at most one.
+    template<class RandomAccessIterator>
+    std::shared_ptr<BinaryNode<ItemType>> buildBalanced(RandomAccessIterator sortedFirst, std::size_t itemCount) const;
+
+    // The two halves of buildFromSorted. A random-access range that is
+    // already sorted is built straight from the range; any other range is
+    // copied into a vector once, sorted if need be, and moved into nodes.
+    template<class RandomAccessIterator>
+    std::shared_ptr<BinaryNode<ItemType>> buildFromRange(RandomAccessIterator first, RandomAccessIterator last,
+                                                         std::random_access_iterator_tag) const;
+    template<class InputIterator>
+    std::shared_ptr<BinaryNode<ItemType>> buildFromRange(InputIterator first, InputIterator last,
+                                                         std::input_iterator_tag) const;
+
+    // As buildBalanced, but links the given childless nodes, in sorted
+    // order, instead of creating new ones. sortedNodes is left empty.
+    std::shared_ptr<BinaryNode<ItemType>> linkBalanced(std::vector<std::shared_ptr<BinaryNode<ItemType>>>& sortedNodes) const;
+
+    // Shared skeleton of buildBalanced and linkBalanced: nodeAt(index)
+    // returns a childless node for the index-th of nodeCount sorted
+    // positions.
+    template<class NodeSource>
+    std::shared_ptr<BinaryNode<ItemType>> balancedSkeleton(std::size_t nodeCount, NodeSource nodeAt) const;
+
+    // Moves every node of the subtree held by subTreeLink, in sorted order
+    // and with its child links cleared, onto the end of sortedNodes. The
+    // subtree is left empty. O(n), and no node is copied.
+    void releaseNodes(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink,
+                      std::vector<std::shared_ptr<BinaryNode<ItemType>>>& sortedNodes);
+
+    // Joins two subtrees and a childless middle node into one tree and
+    // returns its root. Every entry of leftPtr must be <= the middle
+    // entry, and every entry of rightPtr >= it. The shorter subtree is hung
+    // at the matching height on the taller one's outer spine and the path
+    // above it is fixed up with fixUpLink, so the cost is O(height
+    // difference + 1) and an AVLTree stays balanced.
+    std::shared_ptr<BinaryNode<ItemType>> joinNodes(std::shared_ptr<BinaryNode<ItemType>> leftPtr,
+                                                    std::shared_ptr<BinaryNode<ItemType>> middlePtr,
+                                                    std::shared_ptr<BinaryNode<ItemType>> rightPtr);
+
+    // Cuts the subtree into the entries less than key, left in lowerLink,
+    // and the rest, left in upperLink, by joining the pieces hanging off
+    // the search path for key. O(height).
+    void splitNodes(std::shared_ptr<BinaryNode<ItemType>> subTreePtr, const ItemType& key,
+                    std::shared_ptr<BinaryNode<ItemType>>& lowerLink,
+                    std::shared_ptr<BinaryNode<ItemType>>& upperLink);
+
+    // Unlinks the leftmost node of the nonempty subtree held by
+    // subTreeLink and returns it without children. O(height).
+    std::shared_ptr<BinaryNode<ItemType>> detachLeftmostNode(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink);
+
+    // Keeps each of this tree's nodes for which keepNode(item, isInOther)
+    // is true. isInOther tells whether an unmatched equal entry is left in
+    // other; entries are matched one for one, in sorted order.
+    template<class KeepNode>
+    void filterAgainst(const BinarySearchTree<ItemType, Compare>& other, KeepNode keepNode);
+
+    // Returns an iterator to the first entry that is not less than target
+    // (greater than target, if orEqual is false), or end().
+    template<class Key>
+    const_iterator boundIterator(const Key& target, bool orEqual) const;
+
+    // Number of searches a batched lookup keeps in flight. Each waits on
+    // at most one cache miss, so this many misses can overlap.
+    static const int BATCH_LANES = 16;
+
+    // Searches for every key in [first, last), BATCH_LANES at a time, and
+    // calls report(keyIndex, nodePtr) as each search ends, with the node
+    // holding the key or nullptr. Searches end in no particular order.
+    template<class RandomAccessIterator, class Report>
+    void batchDescend(RandomAccessIterator first, RandomAccessIterator last, Report report) const;
 
 public:
     //------------------------------------------------------------
     // Constructor and Destructor Section.
     //------------------------------------------------------------
     // inherits from BinaryNodeTree
+    BinarySearchTree() = default;
+
+    /** Creates an empty tree whose entries are ordered by order. */
+    explicit BinarySearchTree(const Compare& order);
+
+    /** Builds a balanced tree holding the entries in [first, last).
+        See buildFromSorted. */
+    template<class InputIterator>
+    BinarySearchTree(InputIterator first, InputIterator last, const Compare& order = Compare());
+
+    /** Replaces the contents of this tree with the entries in [first, last),
+        arranged as a tree of minimum height. Sorted input is built in O(n)
+        time; unsorted input is sorted first, in O(n log n). A sorted
+        random-access range is read in place, so each entry is copied once,
+        or moved once through a move_iterator; any other range is first
+        gathered into a vector, whose entries are then moved into nodes.
+     @param first, last  The range of entries; it may hold duplicates. */
+    template<class InputIterator>
+    void buildFromSorted(InputIterator first, InputIterator last);
 
     //------------------------------------------------------------
     // Public Methods Section.
     //------------------------------------------------------------
     void setRootData(const ItemType& newData) const;
     bool add(const ItemType& newEntry) override;
+    bool add(ItemType&& newEntry);
+
+    // Adds an entry constructed in place from args, so the item is never
+    // copied or moved.
+    template<class... Args>
+    bool emplace(Args&&... args);
+
     bool remove(const ItemType& anEntry) override;
     ItemType getEntry(const ItemType& anEntry) const override;
     bool contains(const ItemType& anEntry) const override;
+    const ItemType* findEntry(const ItemType& anEntry) const override;
+
+    //------------------------------------------------------------
+    // Batched Lookups Section.
+    // The searches for a batch of keys descend side by side: each takes
+    // one step in turn and prefetches the node it will read next, so the
+    // cache misses of different searches overlap instead of following one
+    // another. Results are written in the order of the keys.
+    //------------------------------------------------------------
+    /** Sets found[i] to contains(first[i]) for each key in [first, last).
+     @param found  A random access iterator to room for last - first
+        results, such as a bool* or a std::vector<char>::iterator. */
+    template<class RandomAccessIterator, class ResultIterator>
+    void containsBatch(RandomAccessIterator first, RandomAccessIterator last, ResultIterator found) const;
+
+    /** Sets entries[i] to findEntry(first[i]) for each key in [first, last).
+     @param entries  A random access iterator to room for last - first
+        const ItemType* results. */
+    template<class RandomAccessIterator, class ResultIterator>
+    void findBatch(RandomAccessIterator first, RandomAccessIterator last, ResultIterator entries) const;
+
+    //------------------------------------------------------------
+    // Order Statistics Section.
+    // Each query follows one root-to-leaf path using the subtree sizes
+    // stored in the nodes, so it takes O(height) time: O(log n) for an
+    // AVLTree.
+    //------------------------------------------------------------
+    /** Counts the entries that are smaller than anEntry.
+     @param anEntry  The entry to compare against; it need not be in the tree.
+     @return  The number of entries less than anEntry. */
+    int countLess(const ItemType& anEntry) const;
+
+    /** Gets the position of an entry in sorted order.
+     @param anEntry  The entry to locate.
+     @return  The zero-based position of the first occurrence of anEntry.
+     @throw  NotFoundException if anEntry is not in the tree. */
+    int rank(const ItemType& anEntry) const;
+
+    /** Gets the k-th smallest entry.
+     @param k  A zero-based position in sorted order.
+     @return  The entry at position k.
+     @throw  PrecondViolatedExcep if k is not in [0, getNumberOfNodes()). */
+    const ItemType& select(int k) const;
+
+    //------------------------------------------------------------
+    // Range Queries Section.
+    // Ranges are half-open: [lo, hi) holds every entry x with
+    // lo <= x < hi. Subtrees that lie wholly outside the range are
+    // never entered.
+    //------------------------------------------------------------
+    /** Visits the entries in [lo, hi) in sorted order.
+        Takes O(height + k) time when k entries are visited.
+     @param lo  The smallest entry to visit; it need not be in the tree.
+     @param hi  The first entry past the range; it is not visited.
+     @param visit  A client-defined function or other callable that is
+        handed each stored entry in the range. */
+    template<class Visitor>
+    void rangeQuery(const ItemType& lo, const ItemType& hi, Visitor visit) const;
+
+    /** Counts the entries in [lo, hi) without visiting them, in O(height)
+        time.
+     @return  The number of entries x with lo <= x < hi; 0 if hi <= lo. */
+    int rangeCount(const ItemType& lo, const ItemType& hi) const;
+
+    //------------------------------------------------------------
+    // Set Operations Section.
+    // Each operation walks both trees in sorted order once and relinks
+    // the surviving nodes into a balanced tree, so it takes O(n + m) time
+    // however the entries interleave. Entries are never copied: a node
+    // either stays where it is, moves from other to this tree, or is
+    // freed. Duplicates are counted as in std::set_union and friends.
+    //------------------------------------------------------------
+    /** Moves every entry of other into this tree, keeping duplicates.
+     @post  other is empty. */
+    void mergeFrom(BinarySearchTree<ItemType, Compare>& other);
+
+    /** Adds the entries of other that this tree lacks. An entry held j
+        times here and k times in other is then held max(j, k) times.
+     @post  other is empty; the entries it did not give up are freed. */
+    void unionWith(BinarySearchTree<ItemType, Compare>& other);
+
+    /** Keeps only the entries that also occur in other, min(j, k) times.
+        other is unchanged. */
+    void intersectWith(const BinarySearchTree<ItemType, Compare>& other);
+
+    /** Removes the entries that occur in other, so an entry is held
+        max(j - k, 0) times. other is unchanged. */
+    void subtract(const BinarySearchTree<ItemType, Compare>& other);
+
+    //------------------------------------------------------------
+    // Split and Join Section.
+    // Both relink existing nodes along one or two root-to-leaf paths, so
+    // they take O(log n) time on an AVLTree and copy no entries. The
+    // parts are shaped by this tree's balancing, so both trees should be
+    // of the same kind. Moving nodes out of a PersistentSearchTree into a
+    // tree that does not share nodes copies every moved node still shared
+    // with another version, which costs O(n).
+    //------------------------------------------------------------
+    /** Moves every entry not less than key into upperPart.
+     @post  This tree holds the entries less than key, and upperPart
+        holds the rest; its previous entries are removed.
+     @throw  PrecondViolatedExcep if upperPart is this tree. */
+    void split(const ItemType& key, BinarySearchTree<ItemType, Compare>& upperPart);
+
+    /** Moves every entry of upperPart onto the high end of this tree.
+     @pre  No entry of upperPart is less than an entry of this tree.
+     @post  upperPart is empty.
+     @throw  PrecondViolatedExcep if the key ranges overlap, or if
+        upperPart is this tree. */
+    void join(BinarySearchTree<ItemType, Compare>& upperPart);
+
+    //------------------------------------------------------------
+    // Iterator Section.
+    // Iterators visit the entries in sorted order, so the tree works with
+    // range-for and the <algorithm> functions. The searches take
+    // O(height) time, as contains does.
+    //------------------------------------------------------------
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /** @return  An iterator to the first entry equal to anEntry, or end(). */
+    const_iterator find(const ItemType& anEntry) const;
+
+    /** @return  An iterator to the first entry not less than anEntry, or end(). */
+    const_iterator lower_bound(const ItemType& anEntry) const;
+
+    /** @return  An iterator to the first entry greater than anEntry, or end(). */
+    const_iterator upper_bound(const ItemType& anEntry) const;
+
+    //------------------------------------------------------------
+    // Heterogeneous Lookup Section.
+    // When Compare declares is_transparent, as DefaultOrder<void> does,
+    // these overloads take any key the ordering can compare with an
+    // ItemType, so a lookup does not have to build a whole entry.
+    // Otherwise only the ItemType versions above exist.
+    //------------------------------------------------------------
+    template<class Key, class Order = Compare, class = typename Order::is_transparent>
+    bool contains(const Key& key) const;
+    template<class Key, class Order = Compare, class = typename Order::is_transparent>
+    const ItemType* findEntry(const Key& key) const;
+    template<class Key, class Order = Compare, class = typename Order::is_transparent>
+    const_iterator find(const Key& key) const;
+    template<class Key, class Order = Compare, class = typename Order::is_transparent>
+    const_iterator lower_bound(const Key& key) const;
+    template<class Key, class Order = Compare, class = typename Order::is_transparent>
+    const_iterator upper_bound(const Key& key) const;
+
+    /** @return  A copy of the ordering the entries are sorted by. */
+    Compare getComparator() const;
+
+    //------------------------------------------------------------
+    // In-Place Update Section.
+    // Each makes a single descent for key, which may be an ItemType or,
+    // with a transparent Compare, any key the ordering accepts. update
+    // receives the stored entry and may change it, but must not change
+    // where it falls in the order.
+    //------------------------------------------------------------
+    /** Calls update on the first entry found equivalent to key; if there
+        is none, adds makeEntry() where the descent ended.
+     @return  True if a new entry was added. */
+    template<class Key, class Update, class MakeEntry>
+    bool addOrUpdate(const Key& key, Update update, MakeEntry makeEntry);
+
+    /** Calls update on the first entry found equivalent to key, and
+        removes that entry if update returns false.
+     @return  True if an entry equivalent to key was found. */
+    template<class Key, class Update>
+    bool updateOrRemove(const Key& key, Update update);
+
+    //------------------------------------------------------------
+    // Snapshot Section.
+    //------------------------------------------------------------
+    /** Copies the entries into an immutable FrozenSearchTree, which answers
+        contains/getEntry with fewer cache misses. Defined in
+        FrozenSearchTree.h, which must be included to call it. The snapshot
+        keeps a copy of this tree's comparator and searches with it. */
+    FrozenSearchTree<ItemType, Compare> freeze() const;
 
 }; // end BinarySearchTree
 
@@ -74,168 +440,1029 @@ public:
 /*********************************************************************************************
 **                      Public Method Implementations                                       **
 *********************************************************************************************/
-template<class ItemType>
-void BinarySearchTree<ItemType>::setRootData(const ItemType& newData) const {
+template<class ItemType, class Compare>
+BinarySearchTree<ItemType, Compare>::BinarySearchTree(const Compare& order)
+        : comparator(order)
+{ }
+
+template<class ItemType, class Compare>
+template<class InputIterator>
+BinarySearchTree<ItemType, Compare>::BinarySearchTree(InputIterator first, InputIterator last, const Compare& order)
+        : comparator(order)
+{
+    buildFromSorted(first, last);
+}
+
+template<class ItemType, class Compare>
+template<class InputIterator>
+void BinarySearchTree<ItemType, Compare>::buildFromSorted(InputIterator first, InputIterator last) {
+    //Built before clear(), so the range may come from this tree itself
+    std::shared_ptr<BinaryNode<ItemType>> newRootPtr =
+        buildFromRange(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+    this->clear();
+    this->rootPtr = std::move(newRootPtr);
+}
+
+template<class ItemType, class Compare>
+template<class RandomAccessIterator>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::buildFromRange(
+        RandomAccessIterator first, RandomAccessIterator last, std::random_access_iterator_tag) const {
+    //Checking costs one pass, and saves both the copy and the sort when the input is already in order
+    if (std::is_sorted(first, last, comparator)) {
+        return buildBalanced(first, static_cast<std::size_t>(last - first));
+    }
+    return buildFromRange(first, last, std::input_iterator_tag());
+}
+
+template<class ItemType, class Compare>
+template<class InputIterator>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::buildFromRange(
+        InputIterator first, InputIterator last, std::input_iterator_tag) const {
+    std::vector<ItemType> sortedItems(first, last);
+    if (!std::is_sorted(sortedItems.begin(), sortedItems.end(), comparator)) {
+        std::sort(sortedItems.begin(), sortedItems.end(), comparator);
+    }
+    return buildBalanced(std::make_move_iterator(sortedItems.begin()), sortedItems.size());
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::setRootData(const ItemType& newData) const {
     std::string message = "Unable to set or change root, please do not use this public method\n";
     throw(PrecondViolatedExcep(message));
 }
 
-template<class ItemType>
-bool BinarySearchTree<ItemType>::add(const ItemType& newEntry) {
+template<class ItemType, class Compare>
+bool BinarySearchTree<ItemType, Compare>::add(const ItemType& newEntry) {
     auto newNodePtr = std::make_shared<BinaryNode<ItemType>>(newEntry);
-    this->rootPtr = placeNode(this->rootPtr, newNodePtr);
+    this->rootPtr = placeNode(std::move(this->rootPtr), std::move(newNodePtr));
+    return true;
+}
+
+template<class ItemType, class Compare>
+bool BinarySearchTree<ItemType, Compare>::add(ItemType&& newEntry) {
+    auto newNodePtr = std::make_shared<BinaryNode<ItemType>>(std::move(newEntry));
+    this->rootPtr = placeNode(std::move(this->rootPtr), std::move(newNodePtr));
     return true;
 }
 
-template<class ItemType>
-bool BinarySearchTree<ItemType>::remove(const ItemType &anEntry) {
+template<class ItemType, class Compare>
+template<class... Args>
+bool BinarySearchTree<ItemType, Compare>::emplace(Args&&... args) {
+    auto newNodePtr = std::make_shared<BinaryNode<ItemType>>(IN_PLACE_ITEM, std::forward<Args>(args)...);
+    this->rootPtr = placeNode(std::move(this->rootPtr), std::move(newNodePtr));
+    return true;
+}
+
+template<class ItemType, class Compare>
+bool BinarySearchTree<ItemType, Compare>::remove(const ItemType &anEntry) {
     bool isSuccessful = false;
-    this->rootPtr = removeValue(this->rootPtr, anEntry, isSuccessful);
+    this->rootPtr = removeValue(std::move(this->rootPtr), anEntry, isSuccessful);
     return isSuccessful;
 }
 
-template<class ItemType>
-ItemType BinarySearchTree<ItemType>::getEntry(const ItemType &anEntry) const {
-    bool entryFound = contains(anEntry);
-    if (entryFound) {
-        return anEntry;
+template<class ItemType, class Compare>
+ItemType BinarySearchTree<ItemType, Compare>::getEntry(const ItemType &anEntry) const {
+    const ItemType* storedEntry = findEntry(anEntry);
+    if (storedEntry != nullptr) {
+        return *storedEntry;
     }
     else{
-        std::string message = "Item found found within binary tree.";
+        std::string message = "Item not found within binary tree.";
+        throw(NotFoundException(message));
+    }
+}
+
+template<class ItemType, class Compare>
+bool BinarySearchTree<ItemType, Compare>::contains(const ItemType &anEntry) const {
+    return findEntry(anEntry) != nullptr;
+}
+
+template<class ItemType, class Compare>
+const ItemType* BinarySearchTree<ItemType, Compare>::findEntry(const ItemType &anEntry) const {
+    //findNode only stops on a node whose item equals anEntry
+    std::shared_ptr<BinaryNode<ItemType>> itemNodePtr = findNode(this->rootPtr, anEntry);
+    return (itemNodePtr == nullptr) ? nullptr : &itemNodePtr->getItem();
+}
+
+template<class ItemType, class Compare>
+template<class RandomAccessIterator, class ResultIterator>
+void BinarySearchTree<ItemType, Compare>::containsBatch(RandomAccessIterator first, RandomAccessIterator last,
+                                               ResultIterator found) const {
+    batchDescend(first, last, [&found](std::size_t keyIndex, const BinaryNode<ItemType>* nodePtr) {
+        found[keyIndex] = (nodePtr != nullptr);
+    });
+}
+
+template<class ItemType, class Compare>
+template<class RandomAccessIterator, class ResultIterator>
+void BinarySearchTree<ItemType, Compare>::findBatch(RandomAccessIterator first, RandomAccessIterator last,
+                                           ResultIterator entries) const {
+    batchDescend(first, last, [&entries](std::size_t keyIndex, const BinaryNode<ItemType>* nodePtr) {
+        entries[keyIndex] = (nodePtr == nullptr) ? nullptr : &nodePtr->getItem();
+    });
+}
+
+template<class ItemType, class Compare>
+int BinarySearchTree<ItemType, Compare>::countLess(const ItemType &anEntry) const {
+    int smallerEntries = 0;
+    BinaryNode<ItemType>* nodePtr = this->rootPtr.get();
+    while (nodePtr != nullptr) {
+        //Entries equal to anEntry may sit on either side of an equal node, so keep looking left
+        if (compareItems(nodePtr->getItem(), anEntry) >= 0) {
+            nodePtr = nodePtr->getLeftChildPtr().get();
+        }
+        //This node and its whole left subtree are smaller
+        else {
+            smallerEntries += this->getNumberOfNodesHelper(nodePtr->getLeftChildPtr()) + 1;
+            nodePtr = nodePtr->getRightChildPtr().get();
+        }
+    }
+    return smallerEntries;
+}
+
+template<class ItemType, class Compare>
+int BinarySearchTree<ItemType, Compare>::rank(const ItemType &anEntry) const {
+    int smallerEntries = 0;
+    BinaryNode<ItemType>* candidatePtr = nullptr;      //Last node on the path that is >= anEntry
+    BinaryNode<ItemType>* nodePtr = this->rootPtr.get();
+    while (nodePtr != nullptr) {
+        if (compareItems(nodePtr->getItem(), anEntry) >= 0) {
+            candidatePtr = nodePtr;
+            nodePtr = nodePtr->getLeftChildPtr().get();
+        }
+        else {
+            smallerEntries += this->getNumberOfNodesHelper(nodePtr->getLeftChildPtr()) + 1;
+            nodePtr = nodePtr->getRightChildPtr().get();
+        }
+    }
+    //The first entry >= anEntry is the last candidate, so that is where anEntry must be
+    if ((candidatePtr == nullptr) || (compareItems(candidatePtr->getItem(), anEntry) != 0)) {
+        std::string message = "Item not found within binary tree.";
         throw(NotFoundException(message));
     }
+    return smallerEntries;
+}
+
+template<class ItemType, class Compare>
+const ItemType& BinarySearchTree<ItemType, Compare>::select(int k) const {
+    if ((k < 0) || (k >= this->getNumberOfNodes())) {
+        std::string message = "select() called with a position outside the tree.";
+        throw(PrecondViolatedExcep(message));
+    }
+    BinaryNode<ItemType>* nodePtr = this->rootPtr.get();
+    while (true) {
+        int leftSize = this->getNumberOfNodesHelper(nodePtr->getLeftChildPtr());
+        if (k < leftSize) {
+            nodePtr = nodePtr->getLeftChildPtr().get();
+        }
+        else if (k == leftSize) {
+            return nodePtr->getItem();
+        }
+        //Skip the left subtree and this node
+        else {
+            k -= leftSize + 1;
+            nodePtr = nodePtr->getRightChildPtr().get();
+        }
+    }
+}
+
+template<class ItemType, class Compare>
+template<class Visitor>
+void BinarySearchTree<ItemType, Compare>::rangeQuery(const ItemType &lo, const ItemType &hi, Visitor visit) const {
+    //Inorder walk that only stacks nodes which can be >= lo
+    std::vector<BinaryNode<ItemType>*> nodeStack;
+    BinaryNode<ItemType>* currentPtr = this->rootPtr.get();
+    while ((currentPtr != nullptr) || !nodeStack.empty()) {
+        while (currentPtr != nullptr) {
+            //This node and its whole left subtree are below the range
+            if (compareItems(lo, currentPtr->getItem()) > 0) {
+                currentPtr = currentPtr->getRightChildPtr().get();
+            }
+            else {
+                nodeStack.push_back(currentPtr);
+                currentPtr = currentPtr->getLeftChildPtr().get();
+            }
+        }
+        currentPtr = nodeStack.back();
+        nodeStack.pop_back();
+        //Entries come out in sorted order, so everything from here on is >= hi
+        if (compareItems(hi, currentPtr->getItem()) <= 0) {
+            return;
+        }
+        visit(currentPtr->getItem());
+        currentPtr = currentPtr->getRightChildPtr().get();
+    }
+}
+
+template<class ItemType, class Compare>
+int BinarySearchTree<ItemType, Compare>::rangeCount(const ItemType &lo, const ItemType &hi) const {
+    if (compareItems(hi, lo) <= 0) {
+        return 0;
+    }
+    return countLess(hi) - countLess(lo);
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::mergeFrom(BinarySearchTree<ItemType, Compare>& other) {
+    if (&other == this) {
+        BinarySearchTree<ItemType, Compare> duplicate(*this);
+        mergeFrom(duplicate);
+        return;
+    }
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>> ourNodes, theirNodes, mergedNodes;
+    releaseNodes(this->rootPtr, ourNodes);
+    //Through other's own detachLink: its nodes may be shared with its other versions
+    other.releaseNodes(other.rootPtr, theirNodes);
+    mergedNodes.reserve(ourNodes.size() + theirNodes.size());
+    std::size_t ours = 0, theirs = 0;
+    while ((ours < ourNodes.size()) && (theirs < theirNodes.size())) {
+        //Ties go to this tree's node first, so equal entries keep their order
+        if (compareItems(ourNodes[ours]->getItem(), theirNodes[theirs]->getItem()) > 0) {
+            mergedNodes.push_back(std::move(theirNodes[theirs++]));
+        }
+        else {
+            mergedNodes.push_back(std::move(ourNodes[ours++]));
+        }
+    }
+    std::move(ourNodes.begin() + ours, ourNodes.end(), std::back_inserter(mergedNodes));
+    std::move(theirNodes.begin() + theirs, theirNodes.end(), std::back_inserter(mergedNodes));
+    this->rootPtr = linkBalanced(mergedNodes);
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::unionWith(BinarySearchTree<ItemType, Compare>& other) {
+    if (&other == this) {
+        return;
+    }
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>> ourNodes, theirNodes, mergedNodes;
+    releaseNodes(this->rootPtr, ourNodes);
+    //Through other's own detachLink: its nodes may be shared with its other versions
+    other.releaseNodes(other.rootPtr, theirNodes);
+    mergedNodes.reserve(ourNodes.size() + theirNodes.size());
+    std::size_t ours = 0, theirs = 0;
+    while ((ours < ourNodes.size()) && (theirs < theirNodes.size())) {
+        int order = compareItems(ourNodes[ours]->getItem(), theirNodes[theirs]->getItem());
+        if (order > 0) {
+            mergedNodes.push_back(std::move(theirNodes[theirs++]));
+        }
+        else if (order < 0) {
+            mergedNodes.push_back(std::move(ourNodes[ours++]));
+        }
+        //A matched pair keeps this tree's node; the other one is freed with theirNodes
+        else {
+            mergedNodes.push_back(std::move(ourNodes[ours++]));
+            theirs++;
+        }
+    }
+    std::move(ourNodes.begin() + ours, ourNodes.end(), std::back_inserter(mergedNodes));
+    std::move(theirNodes.begin() + theirs, theirNodes.end(), std::back_inserter(mergedNodes));
+    this->rootPtr = linkBalanced(mergedNodes);
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::intersectWith(const BinarySearchTree<ItemType, Compare>& other) {
+    if (&other != this) {
+        filterAgainst(other, [](const ItemType&, bool isInOther) { return isInOther; });
+    }
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::subtract(const BinarySearchTree<ItemType, Compare>& other) {
+    if (&other == this) {
+        this->clear();
+    }
+    else {
+        filterAgainst(other, [](const ItemType&, bool isInOther) { return !isInOther; });
+    }
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::split(const ItemType &key, BinarySearchTree<ItemType, Compare> &upperPart) {
+    if (&upperPart == this) {
+        std::string message = "split() called with this tree as its upper part.";
+        throw(PrecondViolatedExcep(message));
+    }
+    upperPart.clear();
+    std::shared_ptr<BinaryNode<ItemType>> lowerPtr;
+    splitNodes(std::move(this->rootPtr), key, lowerPtr, upperPart.rootPtr);
+    this->rootPtr = std::move(lowerPtr);
+    //The subtrees hanging off the split path may still be shared with this tree's
+    //other versions, and upperPart would change them in place
+    if (sharesNodes() && !upperPart.sharesNodes()) {
+        detachAllLinks(upperPart.rootPtr);
+    }
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::join(BinarySearchTree<ItemType, Compare> &upperPart) {
+    if ((&upperPart == this) && !this->isEmpty()) {
+        std::string message = "join() called with this tree as its upper part.";
+        throw(PrecondViolatedExcep(message));
+    }
+    if (upperPart.isEmpty()) {
+        return;
+    }
+    if (!this->isEmpty()) {
+        //Compare this tree's largest entry with upperPart's smallest
+        BinaryNode<ItemType>* largestPtr = this->rootPtr.get();
+        while (largestPtr->getRightChildPtr() != nullptr) {
+            largestPtr = largestPtr->getRightChildPtr().get();
+        }
+        BinaryNode<ItemType>* smallestPtr = upperPart.rootPtr.get();
+        while (smallestPtr->getLeftChildPtr() != nullptr) {
+            smallestPtr = smallestPtr->getLeftChildPtr().get();
+        }
+        if (compareItems(largestPtr->getItem(), smallestPtr->getItem()) > 0) {
+            std::string message = "join() called with overlapping key ranges.";
+            throw(PrecondViolatedExcep(message));
+        }
+    }
+    //upperPart's smallest node becomes the middle node of the join. upperPart's
+    //nodes are detached through its own hooks, and copied out of its other
+    //versions altogether if this tree would otherwise change them in place.
+    std::shared_ptr<BinaryNode<ItemType>> middlePtr = upperPart.detachLeftmostNode(upperPart.rootPtr);
+    if (upperPart.sharesNodes() && !sharesNodes()) {
+        upperPart.detachAllLinks(upperPart.rootPtr);
+    }
+    this->rootPtr = joinNodes(std::move(this->rootPtr), std::move(middlePtr), std::move(upperPart.rootPtr));
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::begin() const {
+    const_iterator first(this);
+    for (BinaryNode<ItemType>* nodePtr = this->rootPtr.get(); nodePtr != nullptr;
+         nodePtr = nodePtr->getLeftChildPtr().get()) {
+        first.path.push_back(nodePtr);
+    }
+    return first;
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::end() const {
+    return const_iterator(this);
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::find(const ItemType &anEntry) const {
+    const_iterator position = boundIterator(anEntry, true);
+    return (position.path.empty() || (compareItems(*position, anEntry) == 0)) ? position : end();
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::lower_bound(const ItemType &anEntry) const {
+    return boundIterator(anEntry, true);
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::upper_bound(const ItemType &anEntry) const {
+    return boundIterator(anEntry, false);
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Order, class>
+bool BinarySearchTree<ItemType, Compare>::contains(const Key& key) const {
+    return findNode(this->rootPtr, key) != nullptr;
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Order, class>
+const ItemType* BinarySearchTree<ItemType, Compare>::findEntry(const Key& key) const {
+    std::shared_ptr<BinaryNode<ItemType>> itemNodePtr = findNode(this->rootPtr, key);
+    return (itemNodePtr == nullptr) ? nullptr : &itemNodePtr->getItem();
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Order, class>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::find(const Key& key) const {
+    const_iterator position = boundIterator(key, true);
+    return (position.path.empty() || (compareItems(*position, key) == 0)) ? position : end();
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Order, class>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::lower_bound(const Key& key) const {
+    return boundIterator(key, true);
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Order, class>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::upper_bound(const Key& key) const {
+    return boundIterator(key, false);
+}
+
+template<class ItemType, class Compare>
+Compare BinarySearchTree<ItemType, Compare>::getComparator() const {
+    return comparator;
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Update, class MakeEntry>
+bool BinarySearchTree<ItemType, Compare>::addOrUpdate(const Key& key, Update update, MakeEntry makeEntry) {
+    LinkPath path;
+    path.reserve(this->getHeightHelper(this->rootPtr));
+    StatsProbe probe(this->statsCounters(), true);
+    std::shared_ptr<BinaryNode<ItemType>>* link = &this->rootPtr;
+    while (*link != nullptr) {
+        detachLink(*link);
+        probe.visited();
+        probe.compared();
+        int order = compareItems(key, (*link)->getItem());
+        if (order == 0) {
+            //The tree keeps its shape, so the path needs no fixing up
+            update((*link)->itemRef());
+            return false;
+        }
+        path.push_back(link);
+        link = (order < 0) ? &(*link)->leftChildLink() : &(*link)->rightChildLink();
+    }
+    *link = std::make_shared<BinaryNode<ItemType>>(makeEntry());
+    fixUpPath(path);
+    return true;
 }
 
-template<class ItemType>
-bool BinarySearchTree<ItemType>::contains(const ItemType &anEntry) const {
-    std::shared_ptr<BinaryNode<ItemType>> potentialItemNode = findNode(this->rootPtr, anEntry);
-    if (potentialItemNode == nullptr)
-        return false;
-    else
-        return potentialItemNode->getItem() == anEntry;
+template<class ItemType, class Compare>
+template<class Key, class Update>
+bool BinarySearchTree<ItemType, Compare>::updateOrRemove(const Key& key, Update update) {
+    LinkPath path;
+    path.reserve(this->getHeightHelper(this->rootPtr));
+    StatsProbe probe(this->statsCounters(), true);
+    std::shared_ptr<BinaryNode<ItemType>>* link = &this->rootPtr;
+    while (*link != nullptr) {
+        detachLink(*link);
+        path.push_back(link);
+        probe.visited();
+        probe.compared();
+        int order = compareItems(key, (*link)->getItem());
+        if (order == 0) {
+            if (!update((*link)->itemRef())) {
+                *link = removeNode(*link);
+                detachLink(*link);
+                fixUpPath(path);
+            }
+            return true;
+        }
+        link = (order < 0) ? &(*link)->leftChildLink() : &(*link)->rightChildLink();
+    }
+    return false;
 }
 
 /*********************************************************************************************
-**                   Protected Method Implementations                                       **
+**                   Iterator Implementation                                                **
 *********************************************************************************************/
-template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType>::placeNode(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
-                                                                  std::shared_ptr<BinaryNode<ItemType>> newNodePtr){
-    if (subTreePtr == nullptr) {    //root of subtree
-        return newNodePtr;
+template<class ItemType, class Compare>
+BinarySearchTree<ItemType, Compare>::const_iterator::const_iterator()
+        : treePtr(nullptr)
+{ }
+
+template<class ItemType, class Compare>
+BinarySearchTree<ItemType, Compare>::const_iterator::const_iterator(const BinarySearchTree<ItemType, Compare>* aTreePtr)
+        : treePtr(aTreePtr)
+{
+    path.reserve(treePtr->getHeight());
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator::reference
+BinarySearchTree<ItemType, Compare>::const_iterator::operator*() const {
+    return path.back()->getItem();
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator::pointer
+BinarySearchTree<ItemType, Compare>::const_iterator::operator->() const {
+    return &path.back()->getItem();
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator& BinarySearchTree<ItemType, Compare>::const_iterator::operator++() {
+    BinaryNode<ItemType>* nodePtr = path.back()->getRightChildPtr().get();
+    //With a right subtree, the next entry is its leftmost node
+    if (nodePtr != nullptr) {
+        for (; nodePtr != nullptr; nodePtr = nodePtr->getLeftChildPtr().get()) {
+            path.push_back(nodePtr);
+        }
+    }
+    //Otherwise climb until the climb leaves a left subtree; that parent is next
+    else {
+        do {
+            nodePtr = path.back();
+            path.pop_back();
+        } while (!path.empty() && (path.back()->getRightChildPtr().get() == nodePtr));
     }
-    //If the established node's item is > than the new node's item, then attach towards left branch
-    else if (subTreePtr->getItem() > newNodePtr->getItem() ){
-        auto tempPtr = placeNode(subTreePtr->getLeftChildPtr(), newNodePtr);
-        subTreePtr->setLeftChildPtr(tempPtr);
+    return *this;
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::const_iterator::operator++(int) {
+    const_iterator previous = *this;
+    ++(*this);
+    return previous;
+}
+
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator& BinarySearchTree<ItemType, Compare>::const_iterator::operator--() {
+    //From end(), and with a left subtree, the previous entry is a rightmost node
+    BinaryNode<ItemType>* nodePtr = path.empty() ? treePtr->rootPtr.get() : path.back()->getLeftChildPtr().get();
+    if (nodePtr != nullptr) {
+        for (; nodePtr != nullptr; nodePtr = nodePtr->getRightChildPtr().get()) {
+            path.push_back(nodePtr);
+        }
     }
-        //If the established node's item is < than the new node's item, then attach towards right branch
+    //Otherwise climb until the climb leaves a right subtree; that parent is previous
     else {
-        auto tempPtr = placeNode(subTreePtr->getRightChildPtr(), newNodePtr);
-        subTreePtr->setRightChildPtr(tempPtr);
+        do {
+            nodePtr = path.back();
+            path.pop_back();
+        } while (!path.empty() && (path.back()->getLeftChildPtr().get() == nodePtr));
     }
-    return subTreePtr;
+    return *this;
 }
 
-template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType>::removeValue(
-        std::shared_ptr<BinaryNode<ItemType>> subTreePtr, const ItemType& target, bool &success) {
-    if (subTreePtr == nullptr){
-        success = false;
+template<class ItemType, class Compare>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::const_iterator::operator--(int) {
+    const_iterator previous = *this;
+    --(*this);
+    return previous;
+}
+
+template<class ItemType, class Compare>
+bool BinarySearchTree<ItemType, Compare>::const_iterator::operator==(const const_iterator& rightHandSide) const {
+    if (path.empty() || rightHandSide.path.empty()) {
+        return path.empty() && rightHandSide.path.empty();
     }
-    else if (subTreePtr->getItem() == target)
-    {
-        //Item is in the root of the subtree
-        subTreePtr = removeNode(subTreePtr);
-        success = true;
+    return path.back() == rightHandSide.path.back();
+}
+
+template<class ItemType, class Compare>
+bool BinarySearchTree<ItemType, Compare>::const_iterator::operator!=(const const_iterator& rightHandSide) const {
+    return !(*this == rightHandSide);
+}
+
+/*********************************************************************************************
+**                   Protected Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+template<class Left, class Right>
+int BinarySearchTree<ItemType, Compare>::compareItems(const Left& leftItem, const Right& rightItem) const {
+    return threeWayCompare(comparator, leftItem, rightItem, 0);
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::placeNode(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
+                                                                  std::shared_ptr<BinaryNode<ItemType>> newNodePtr){
+    LinkPath path;
+    path.reserve(this->getHeightHelper(subTreePtr));
+    StatsProbe probe(this->statsCounters(), true);
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreePtr;
+    while (*link != nullptr) {
+        detachLink(*link);
+        path.push_back(link);
+        probe.visited();
+        probe.compared();
+        //If the established node's item is > than the new node's item, then attach towards left branch
+        if (compareItems((*link)->getItem(), newNodePtr->getItem()) > 0) {
+            link = &(*link)->leftChildLink();
+        }
+        //If the established node's item is <= the new node's item, then attach towards right branch
+        else {
+            link = &(*link)->rightChildLink();
+        }
     }
-    else if (subTreePtr->getItem() > target){
-        //Search left subTree
-        auto tempPtr = removeValue(subTreePtr->getLeftChildPtr(), target, success);
-        subTreePtr->setLeftChildPtr(tempPtr);
+    *link = std::move(newNodePtr);      //empty link is where the new leaf goes
+    fixUpPath(path);
+    return subTreePtr;
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::removeValue(
+        std::shared_ptr<BinaryNode<ItemType>> subTreePtr, const ItemType& target, bool &success) {
+    LinkPath path;
+    path.reserve(this->getHeightHelper(subTreePtr));
+    StatsProbe probe(this->statsCounters(), true);
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreePtr;
+    success = false;
+    while (*link != nullptr) {
+        detachLink(*link);
+        path.push_back(link);
+        probe.visited();
+        probe.compared();
+        int order = compareItems(target, (*link)->getItem());
+        if (order == 0) {
+            //Item is in the root of this subtree
+            *link = removeNode(*link);
+            detachLink(*link);
+            success = true;
+            break;
+        }
+        //Search left or right subTree
+        link = (order < 0) ? &(*link)->leftChildLink() : &(*link)->rightChildLink();
     }
-    else {
-        //Search the right subTree
-        auto tempPtr = removeValue(subTreePtr->getRightChildPtr(), target, success);
-        subTreePtr->setRightChildPtr(tempPtr);
+    if (success) {
+        fixUpPath(path);
     }
     return subTreePtr;
 }
 
-template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType>::removeNode(
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::removeNode(
         std::shared_ptr<BinaryNode<ItemType>> nodePtr) {
 
-    //Mark if there is a single child and leaf in either the left or right branch
-    bool hasSingleLeftChild = (nodePtr->getRightChildPtr() == nullptr) && (nodePtr->getLeftChildPtr() != nullptr);
-    bool hasSingleRightChild = (nodePtr->getRightChildPtr() != nullptr) && (nodePtr->getLeftChildPtr() == nullptr);
-
     //If it's a leaf, we can delete this node
     if (nodePtr->isLeaf()) {
-        nodePtr = nullptr;
-        return nodePtr;
+        return nullptr;
     }
     //If there's one child, then connect parent node to grandchild node of the child node being deleted
-    else if (hasSingleLeftChild || hasSingleRightChild){
-        auto nodeToConnectPtr = std::make_shared<BinaryNode<ItemType>>();        //Initialize node we're returning
-        if (hasSingleLeftChild){
-            nodeToConnectPtr = nodePtr->getLeftChildPtr();
-        }
-        else {
-            nodeToConnectPtr = nodePtr->getRightChildPtr();
-        }
-        return nodeToConnectPtr;
+    else if (nodePtr->getRightChildPtr() == nullptr) {
+        return nodePtr->getLeftChildPtr();
+    }
+    else if (nodePtr->getLeftChildPtr() == nullptr) {
+        return nodePtr->getRightChildPtr();
     }
     else {   //nodePtr has two children
         //Find the inorder successor of the entry in nodePtr: it is the left subtree rooted
         //at nodePtr's right child
 
-        //Mark the current node's item, will use to replace the node we're removing
-        ItemType inorderSuccessor = nodePtr->getItem();
+        //The item being removed is given up, so it is moved out rather than copied;
+        //the variable then receives the successor, also by move
+        ItemType inorderSuccessor = nodePtr->takeItem();
         //Traverse down the right branch's leftmost node (not necessarily child node)
-        auto tempPtr = removeLeftmostNode(nodePtr->getRightChildPtr(), inorderSuccessor);
+        auto tempPtr = removeLeftmostNode(std::move(nodePtr->rightChildLink()), inorderSuccessor);
         //Set local node's right child to the node found in tempPtr
-        nodePtr->setRightChildPtr(tempPtr);
+        nodePtr->setRightChildPtr(std::move(tempPtr));
         //Set local node's item to the deleted node's item
-        nodePtr->setItem(inorderSuccessor);
+        nodePtr->setItem(std::move(inorderSuccessor));
         return nodePtr;
     }
 }
 
-template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType>::removeLeftmostNode(
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::removeLeftmostNode(
         std::shared_ptr<BinaryNode<ItemType>> subTreePtr, ItemType& inorderSuccessor) {
-    if (subTreePtr->getLeftChildPtr() == nullptr){
-        //This is the node we're searching for, it has no left child, but might have a right subtree
-        inorderSuccessor = subTreePtr->getItem();
-        return removeNode(subTreePtr);
+    LinkPath path;
+    path.reserve(this->getHeightHelper(subTreePtr));
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreePtr;
+    //Traverse down the left links to the furthest left descendant
+    detachLink(*link);
+    while ((*link)->getLeftChildPtr() != nullptr) {
+        path.push_back(link);
+        link = &(*link)->leftChildLink();
+        detachLink(*link);
     }
-    else {
-        //Traverse down the right child of root, furthest left descendant.
-        auto tempPtr = removeLeftmostNode(subTreePtr->getLeftChildPtr(), inorderSuccessor);
-        subTreePtr->setLeftChildPtr(tempPtr);
-        return subTreePtr;
+    //This is the node we're searching for, it has no left child, but might have a right subtree
+    path.push_back(link);
+    inorderSuccessor = (*link)->takeItem();
+    *link = removeNode(*link);
+    //The subtree that took its place is fixed up with the rest of the path
+    detachLink(*link);
+    fixUpPath(path);
+    return subTreePtr;
+}
+
+template<class ItemType, class Compare>
+template<class Key>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::findNode(const std::shared_ptr<BinaryNode<ItemType>>& subTreePtr,
+                                                                 const Key &target) const {
+    const std::shared_ptr<BinaryNode<ItemType>>* link = &subTreePtr;
+    StatsProbe probe(this->statsCounters(), true);
+    //When the link is nullptr, we've walked past a leaf
+    while (*link != nullptr) {
+        probe.visited();
+        probe.compared();
+        //One three-way comparison decides between this node and either branch
+        int order = compareItems(target, (*link)->getItem());
+        //If child node is equal to the target, return pointer to this node
+        if (order == 0) {
+            return *link;
+        }
+        //If the local node's item is greater than the target, then search the left branch,
+        //otherwise search the right branch
+        link = (order < 0) ? &(*link)->getLeftChildPtr() : &(*link)->getRightChildPtr();
     }
+    return nullptr;
 }
 
-template<class ItemType>
-std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType>::findNode(std::shared_ptr<BinaryNode<ItemType>> subTreePtr,
-                                                                 const ItemType &target) const {
-    //If current subTree root is nullptr, we're at a leaf
-    if (subTreePtr == nullptr){
-        return subTreePtr;
+template<class ItemType, class Compare>
+template<class RandomAccessIterator, class Report>
+void BinarySearchTree<ItemType, Compare>::batchDescend(RandomAccessIterator first, RandomAccessIterator last,
+                                              Report report) const {
+    //One search in flight: the key it looks for and the node it reads next
+    struct Lane {
+        std::size_t keyIndex;
+        const BinaryNode<ItemType>* nodePtr;
+        int depth;
+        int comparisons;
+    };
+    const BinaryNode<ItemType>* rootNodePtr = this->rootPtr.get();
+    const std::size_t keyCount = static_cast<std::size_t>(last - first);
+    Lane lanes[BATCH_LANES];
+    std::size_t activeLanes = 0;
+    std::size_t nextKey = 0;
+    while ((activeLanes < BATCH_LANES) && (nextKey < keyCount)) {
+        lanes[activeLanes++] = Lane{nextKey++, rootNodePtr, 0, 0};
     }
-    //If child node is equal to the target, return pointer to this node
-    else if (subTreePtr->getItem() == target) {
-        return subTreePtr;
+
+    //Each pass moves every active search down one level
+    while (activeLanes > 0) {
+        std::size_t laneIndex = 0;
+        while (laneIndex < activeLanes) {
+            Lane& lane = lanes[laneIndex];
+            const BinaryNode<ItemType>* nodePtr = lane.nodePtr;
+            bool isFinished = (nodePtr == nullptr);
+            if (!isFinished) {
+                int order = compareItems(first[lane.keyIndex], nodePtr->getItem());
+                lane.depth++;
+                lane.comparisons++;
+                if (order == 0) {
+                    isFinished = true;
+                }
+                else {
+                    lane.nodePtr = (order < 0) ? nodePtr->getLeftChildPtr().get()
+                                               : nodePtr->getRightChildPtr().get();
+#if defined(__GNUC__)
+                    //The other lanes take their steps while this line is fetched
+                    if (lane.nodePtr != nullptr) {
+                        __builtin_prefetch(lane.nodePtr);
+                    }
+#endif
+                }
+            }
+            if (!isFinished) {
+                laneIndex++;
+                continue;
+            }
+
+            report(lane.keyIndex, nodePtr);
+            {
+                StatsProbe probe(this->statsCounters(), true);
+                probe.visited(lane.depth);
+                probe.compared(lane.comparisons);
+            }
+            //Start the next key in this lane, or close the lane by moving the last one into it
+            if (nextKey < keyCount) {
+                lane = Lane{nextKey++, rootNodePtr, 0, 0};
+                laneIndex++;
+            }
+            else {
+                lane = lanes[--activeLanes];
+            }
+        }
     }
-    //If the local node's item is greater than the target, then search the left branch
-    else if (subTreePtr->getItem() > target){
-        return findNode(subTreePtr->getLeftChildPtr(), target);
+}
+
+template<class ItemType, class Compare>
+template<class RandomAccessIterator>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::buildBalanced(
+        RandomAccessIterator sortedFirst, std::size_t itemCount) const {
+    return balancedSkeleton(itemCount, [sortedFirst](std::size_t index) {
+        return std::make_shared<BinaryNode<ItemType>>(IN_PLACE_ITEM, *(sortedFirst + index));
+    });
+}
+
+template<class ItemType, class Compare>
+template<class NodeSource>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::balancedSkeleton(std::size_t nodeCount,
+                                                                                   NodeSource nodeAt) const {
+    //Each frame is a range of positions still to be built and the empty link that will hold it
+    struct BuildFrame {
+        std::size_t first;
+        std::size_t last;
+        std::shared_ptr<BinaryNode<ItemType>>* link;
+    };
+    std::shared_ptr<BinaryNode<ItemType>> subTreePtr;
+    std::vector<BuildFrame> frameStack;
+    if (nodeCount > 0) {
+        frameStack.push_back(BuildFrame{0, nodeCount, &subTreePtr});
     }
-    //If the local node's item is leass than the target, then search the right branch
-    else {
-        return findNode(subTreePtr->getRightChildPtr(), target);
+    while (!frameStack.empty()) {
+        BuildFrame frame = frameStack.back();
+        frameStack.pop_back();
+        std::size_t count = frame.last - frame.first;
+        std::size_t middle = frame.first + count / 2;
+        *frame.link = nodeAt(middle);
+
+        //A minimum-height tree of count nodes is as tall as count has bits
+        int height = 0;
+        for (std::size_t remaining = count; remaining > 0; remaining >>= 1) {
+            height++;
+        }
+        (*frame.link)->setHeight(height);
+        (*frame.link)->setSize(static_cast<int>(count));
+
+        if (middle + 1 < frame.last) {
+            frameStack.push_back(BuildFrame{middle + 1, frame.last, &(*frame.link)->rightChildLink()});
+        }
+        if (frame.first < middle) {
+            frameStack.push_back(BuildFrame{frame.first, middle, &(*frame.link)->leftChildLink()});
+        }
+    }
+    return subTreePtr;
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::linkBalanced(
+        std::vector<std::shared_ptr<BinaryNode<ItemType>>>& sortedNodes) const {
+    std::shared_ptr<BinaryNode<ItemType>> subTreePtr = balancedSkeleton(sortedNodes.size(),
+        [&sortedNodes](std::size_t index) { return std::move(sortedNodes[index]); });
+    sortedNodes.clear();
+    return subTreePtr;
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::releaseNodes(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink,
+                                              std::vector<std::shared_ptr<BinaryNode<ItemType>>>& sortedNodes) {
+    //An inorder walk over links. A node is moved out of its link once its left
+    //subtree has been moved out, and its right subtree is walked from its new place.
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>*> linkStack;
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreeLink;
+    while ((*link != nullptr) || !linkStack.empty()) {
+        while (*link != nullptr) {
+            detachLink(*link);
+            linkStack.push_back(link);
+            link = &(*link)->leftChildLink();
+        }
+        link = linkStack.back();
+        linkStack.pop_back();
+        sortedNodes.push_back(std::move(*link));
+        link = &sortedNodes.back()->rightChildLink();
+    }
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::joinNodes(std::shared_ptr<BinaryNode<ItemType>> leftPtr,
+                                                                  std::shared_ptr<BinaryNode<ItemType>> middlePtr,
+                                                                  std::shared_ptr<BinaryNode<ItemType>> rightPtr) {
+    int leftHeight = this->getHeightHelper(leftPtr);
+    int rightHeight = this->getHeightHelper(rightPtr);
+    std::shared_ptr<BinaryNode<ItemType>> subTreePtr;
+    LinkPath path;
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreePtr;
+    //Walk down the taller tree's inner-facing spine to a subtree no more than
+    //one level taller than the shorter tree; the middle node takes its place
+    if (leftHeight > rightHeight + 1) {
+        subTreePtr = std::move(leftPtr);
+        while (this->getHeightHelper(*link) > rightHeight + 1) {
+            detachLink(*link);
+            path.push_back(link);
+            link = &(*link)->rightChildLink();
+        }
+        leftPtr = std::move(*link);
+    }
+    else if (rightHeight > leftHeight + 1) {
+        subTreePtr = std::move(rightPtr);
+        while (this->getHeightHelper(*link) > leftHeight + 1) {
+            detachLink(*link);
+            path.push_back(link);
+            link = &(*link)->leftChildLink();
+        }
+        rightPtr = std::move(*link);
+    }
+    middlePtr->leftChildLink() = std::move(leftPtr);
+    middlePtr->rightChildLink() = std::move(rightPtr);
+    *link = std::move(middlePtr);
+    path.push_back(link);
+    fixUpPath(path);
+    return subTreePtr;
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::splitNodes(std::shared_ptr<BinaryNode<ItemType>> subTreePtr, const ItemType& key,
+                                            std::shared_ptr<BinaryNode<ItemType>>& lowerLink,
+                                            std::shared_ptr<BinaryNode<ItemType>>& upperLink) {
+    //Walk down the search path for key, cutting each node loose from the
+    //child the walk continues into
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>> pathNodes;
+    std::vector<bool> isUpperNode;
+    pathNodes.reserve(this->getHeightHelper(subTreePtr));
+    while (subTreePtr != nullptr) {
+        detachLink(subTreePtr);
+        bool isUpper = compareItems(subTreePtr->getItem(), key) >= 0;
+        std::shared_ptr<BinaryNode<ItemType>> nextPtr = isUpper ? std::move(subTreePtr->leftChildLink())
+                                                                : std::move(subTreePtr->rightChildLink());
+        pathNodes.push_back(std::move(subTreePtr));
+        isUpperNode.push_back(isUpper);
+        subTreePtr = std::move(nextPtr);
+    }
+
+    //Deepest first, each node and its remaining subtree join the side it belongs to.
+    //The parts being joined grow in height as the walk climbs, so the joins cost
+    //O(height) in total.
+    lowerLink = nullptr;
+    upperLink = nullptr;
+    for (std::size_t index = pathNodes.size(); index-- > 0;) {
+        std::shared_ptr<BinaryNode<ItemType>>& nodePtr = pathNodes[index];
+        if (isUpperNode[index]) {
+            std::shared_ptr<BinaryNode<ItemType>> rightPtr = std::move(nodePtr->rightChildLink());
+            upperLink = joinNodes(std::move(upperLink), std::move(nodePtr), std::move(rightPtr));
+        }
+        else {
+            std::shared_ptr<BinaryNode<ItemType>> leftPtr = std::move(nodePtr->leftChildLink());
+            lowerLink = joinNodes(std::move(leftPtr), std::move(nodePtr), std::move(lowerLink));
+        }
+    }
+}
+
+template<class ItemType, class Compare>
+std::shared_ptr<BinaryNode<ItemType>> BinarySearchTree<ItemType, Compare>::detachLeftmostNode(
+        std::shared_ptr<BinaryNode<ItemType>>& subTreeLink) {
+    LinkPath path;
+    std::shared_ptr<BinaryNode<ItemType>>* link = &subTreeLink;
+    detachLink(*link);
+    while ((*link)->getLeftChildPtr() != nullptr) {
+        path.push_back(link);
+        link = &(*link)->leftChildLink();
+        detachLink(*link);
+    }
+    std::shared_ptr<BinaryNode<ItemType>> leftmostPtr = std::move(*link);
+    *link = std::move(leftmostPtr->rightChildLink());
+    fixUpPath(path);
+    return leftmostPtr;
+}
+
+template<class ItemType, class Compare>
+template<class KeepNode>
+void BinarySearchTree<ItemType, Compare>::filterAgainst(const BinarySearchTree<ItemType, Compare>& other, KeepNode keepNode) {
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>> ourNodes, keptNodes;
+    releaseNodes(this->rootPtr, ourNodes);
+    keptNodes.reserve(ourNodes.size());
+    TraversalCursor<ItemType> theirCursor = other.inorderCursor();
+    for (auto& nodePtr : ourNodes) {
+        const ItemType& ourItem = nodePtr->getItem();
+        while (theirCursor.hasNext() && (compareItems(ourItem, theirCursor.peek()) > 0)) {
+            theirCursor.next();
+        }
+        bool isInOther = theirCursor.hasNext() && (compareItems(theirCursor.peek(), ourItem) == 0);
+        if (isInOther) {
+            theirCursor.next();
+        }
+        if (keepNode(ourItem, isInOther)) {
+            keptNodes.push_back(std::move(nodePtr));
+        }
+    }
+    this->rootPtr = linkBalanced(keptNodes);
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::fixUpLink(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink) {
+    if (subTreeLink != nullptr) {
+        subTreeLink->updateAugmentation();
+    }
+}
+
+template<class ItemType, class Compare>
+bool BinarySearchTree<ItemType, Compare>::sharesNodes() const {
+    return false;
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::detachAllLinks(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink) {
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>*> linkStack;
+    if (subTreeLink != nullptr) {
+        linkStack.push_back(&subTreeLink);
+    }
+    while (!linkStack.empty()) {
+        std::shared_ptr<BinaryNode<ItemType>>* link = linkStack.back();
+        linkStack.pop_back();
+        detachLink(*link);
+        if ((*link)->getLeftChildPtr() != nullptr) {
+            linkStack.push_back(&(*link)->leftChildLink());
+        }
+        if ((*link)->getRightChildPtr() != nullptr) {
+            linkStack.push_back(&(*link)->rightChildLink());
+        }
+    }
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::detachLink(std::shared_ptr<BinaryNode<ItemType>>&) {
+}
+
+template<class ItemType, class Compare>
+template<class Key>
+typename BinarySearchTree<ItemType, Compare>::const_iterator BinarySearchTree<ItemType, Compare>::boundIterator(const Key& target,
+                                                                                                          bool orEqual) const {
+    const_iterator position(this);
+    std::size_t boundLength = 0;      //Path length up to the last node that satisfied the bound
+    BinaryNode<ItemType>* nodePtr = this->rootPtr.get();
+    while (nodePtr != nullptr) {
+        position.path.push_back(nodePtr);
+        int order = compareItems(nodePtr->getItem(), target);
+        if ((order > 0) || (orEqual && (order == 0))) {
+            boundLength = position.path.size();
+            nodePtr = nodePtr->getLeftChildPtr().get();
+        }
+        else {
+            nodePtr = nodePtr->getRightChildPtr().get();
+        }
+    }
+    //The last node on the path that satisfies the bound is the first such entry
+    position.path.resize(boundLength);
+    return position;
+}
+
+template<class ItemType, class Compare>
+void BinarySearchTree<ItemType, Compare>::fixUpPath(const LinkPath& path) {
+    for (auto link = path.rbegin(); link != path.rend(); ++link) {
+        fixUpLink(**link);
     }
 }
 
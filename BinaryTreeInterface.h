@@ -8,6 +8,7 @@
 #ifndef BINARY_TREE_INTERFACE_
 #define BINARY_TREE_INTERFACE_
 
+#include <utility>
 
 template<class ItemType>
 class BinaryTreeInterface
@@ -81,4 +82,11 @@ public:
 
 }; // end BinaryTreeInterface
 
+/** Default template argument for the traversals that take any callable:
+    it is well formed only when visit can be called with a const ItemType&.
+    Any other visitor, such as a lambda taking ItemType&, is left to the
+    overloads above that take void visit(ItemType&). */
+template<class Visitor, class ItemType>
+using EnableIfConstVisitor = decltype(std::declval<Visitor&>()(std::declval<const ItemType&>()), void());
+
 #endif //LAB_6_BST_BINARYTREEINTERFACE_H
@@ -0,0 +1,327 @@
+/** AVL tree that many threads can search while other threads change it.
+ Readers never lock. Each one registers itself in a reader counter, reads
+ the currently published version of the tree through plain pointers, and
+ leaves. Writers take one writer lock. A write copies only the nodes on
+ its path, as in a PersistentSearchTree, so nodes that readers may be
+ looking at are never changed. The writer then publishes the new root
+ and waits until every reader that might still hold the old version has
+ left before letting go of the nodes only that version used. Entries are
+ ordered by Compare, as in BinarySearchTree; a transparent Compare also
+ lets readers look entries up by key.
+ @file ConcurrentSearchTree.h */
+
+#ifndef CONCURRENT_SEARCH_TREE_
+#define CONCURRENT_SEARCH_TREE_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "BinaryNode.h"
+#include "PersistentSearchTree.h"
+#include "NotFoundException.h"
+
+// Reader counters per phase. Readers are spread over them by thread, so
+// that they do not all contend for one cache line.
+const int READER_STRIPES = 16;
+
+template<class ItemType, class Compare = DefaultOrder<ItemType>>
+class ConcurrentSearchTree : protected PersistentSearchTree<ItemType, Compare>
+{
+private:
+    // One reader counter, padded out to a cache line of its own.
+    struct ReaderCounter
+    {
+        std::atomic<int> count;
+        char padding[64 - sizeof(std::atomic<int>)];
+    };
+
+    // Registers a reader for the lifetime of the guard.
+    class ReadSection
+    {
+    private:
+        const ConcurrentSearchTree<ItemType, Compare>& tree;
+        std::atomic<int>* counterPtr;
+    public:
+        explicit ReadSection(const ConcurrentSearchTree<ItemType, Compare>& aTree);
+        ~ReadSection();
+        BinaryNode<ItemType>* getRoot() const;
+    };
+
+    // Owns the published version, so that none of its nodes is freed or
+    // changed while it is published.
+    std::shared_ptr<BinaryNode<ItemType>> publishedRootPtr;
+    // The published root as readers see it.
+    std::atomic<BinaryNode<ItemType>*> readerRootPtr;
+
+    // Readers count themselves in the current phase. A writer flips the
+    // phase and waits for the old phase's counters to drain.
+    mutable ReaderCounter activeReaders[2][READER_STRIPES];
+    std::atomic<int> readerPhase;
+
+    std::mutex writerMutex;
+
+protected:
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    // Writers detach shared nodes as PersistentSearchTree does. Only the
+    // writer changes reference counts, so use_count() is exact there.
+    //------------------------------------------------------------
+    // Publishes the writer's version and waits out the readers of the
+    // old one. writerMutex must be held.
+    void publish();
+
+    // Returns the node holding target in the subtree, without touching
+    // any reference count, or nullptr.
+    template<class Key>
+    const BinaryNode<ItemType>* findNodeIn(const BinaryNode<ItemType>* subTreePtr, const Key& target) const;
+
+public:
+    //------------------------------------------------------------
+    // Constructor and Destructor Section.
+    //------------------------------------------------------------
+    ConcurrentSearchTree();
+
+    // Creates an empty tree whose entries are ordered by order.
+    explicit ConcurrentSearchTree(const Compare& order);
+
+    // Publishes a balanced tree of the entries in [first, last); see
+    // BinarySearchTree::buildFromSorted.
+    template<class InputIterator>
+    ConcurrentSearchTree(InputIterator first, InputIterator last, const Compare& order = Compare());
+
+    ConcurrentSearchTree(const ConcurrentSearchTree<ItemType, Compare>& tree) = delete;
+    ConcurrentSearchTree& operator=(const ConcurrentSearchTree<ItemType, Compare>& rightHandSide) = delete;
+
+    //------------------------------------------------------------
+    // Writer Methods Section.
+    // Writers run one at a time. Each copies the O(log n) nodes on its
+    // path, so the writer lock is held for O(log n) work plus the wait
+    // for readers that started before the write was published.
+    //------------------------------------------------------------
+    bool add(const ItemType& newEntry);
+    bool remove(const ItemType& anEntry);
+    void clear();
+
+    //------------------------------------------------------------
+    // Reader Methods Section.
+    // Readers never block, and each one sees a single published version
+    // of the tree from start to end.
+    //------------------------------------------------------------
+    bool isEmpty() const;
+    int getHeight() const;
+    int getNumberOfNodes() const;
+    bool contains(const ItemType& anEntry) const;
+
+    // Returns a copy of the stored entry; a reference could outlive the
+    // version that holds it.
+    ItemType getEntry(const ItemType& anEntry) const;
+
+    // Lookups by any key the ordering can compare with ItemType, for a
+    // transparent Compare; see BinarySearchTree.
+    template<class Key, class Order = Compare, class = typename Order::is_transparent>
+    bool contains(const Key& key) const;
+    template<class Key, class Order = Compare, class = typename Order::is_transparent>
+    ItemType getEntry(const Key& key) const;
+
+    // Hands visit, which may be any callable, each entry of one version in
+    // sorted order. visit must not write to this tree, since writers wait
+    // for readers to finish.
+    template<class Visitor>
+    void inorderTraverse(Visitor visit) const;
+}; // end ConcurrentSearchTree
+
+
+
+/*********************************************************************************************
+**                   Read Section Implementation                                            **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+ConcurrentSearchTree<ItemType, Compare>::ReadSection::ReadSection(const ConcurrentSearchTree<ItemType, Compare>& aTree)
+        : tree(aTree)
+{
+    static thread_local std::size_t stripe = std::hash<std::thread::id>()(std::this_thread::get_id()) % READER_STRIPES;
+    //A writer may flip the phase between the load and the increment; the reader
+    //then backs out, since that writer may not be waiting for it
+    while (true) {
+        int phase = tree.readerPhase.load();
+        counterPtr = &tree.activeReaders[phase][stripe].count;
+        counterPtr->fetch_add(1);
+        if (tree.readerPhase.load() == phase)
+            break;
+        counterPtr->fetch_sub(1);
+    }
+}
+
+template<class ItemType, class Compare>
+ConcurrentSearchTree<ItemType, Compare>::ReadSection::~ReadSection() {
+    counterPtr->fetch_sub(1);
+}
+
+template<class ItemType, class Compare>
+BinaryNode<ItemType>* ConcurrentSearchTree<ItemType, Compare>::ReadSection::getRoot() const {
+    return tree.readerRootPtr.load();
+}
+
+/*********************************************************************************************
+**                   Protected Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+void ConcurrentSearchTree<ItemType, Compare>::publish() {
+    std::shared_ptr<BinaryNode<ItemType>> retiredRootPtr = std::move(publishedRootPtr);
+    publishedRootPtr = this->rootPtr;
+    readerRootPtr.store(publishedRootPtr.get());
+
+    //Readers of the old phase may hold the old root; new readers see the new one
+    int oldPhase = readerPhase.load();
+    readerPhase.store(1 - oldPhase);
+    for (int stripe = 0; stripe < READER_STRIPES; stripe++) {
+        while (activeReaders[oldPhase][stripe].count.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}  //The nodes only the old version used are freed with retiredRootPtr
+
+template<class ItemType, class Compare>
+template<class Key>
+const BinaryNode<ItemType>* ConcurrentSearchTree<ItemType, Compare>::findNodeIn(const BinaryNode<ItemType>* subTreePtr,
+                                                                               const Key& target) const {
+    //Ordered by the tree's comparator, as the writers that built the version were
+    while (subTreePtr != nullptr) {
+        int order = this->compareItems(subTreePtr->getItem(), target);
+        if (order == 0) {
+            return subTreePtr;
+        }
+        subTreePtr = (order > 0) ? subTreePtr->getLeftChildPtr().get()
+                                 : subTreePtr->getRightChildPtr().get();
+    }
+    return nullptr;
+}
+
+/*********************************************************************************************
+**                      Public Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+ConcurrentSearchTree<ItemType, Compare>::ConcurrentSearchTree()
+        : ConcurrentSearchTree(Compare())
+{
+}
+
+template<class ItemType, class Compare>
+ConcurrentSearchTree<ItemType, Compare>::ConcurrentSearchTree(const Compare& order)
+        : PersistentSearchTree<ItemType, Compare>(order), readerRootPtr(nullptr), readerPhase(0)
+{
+    for (auto& phaseCounters : activeReaders) {
+        for (auto& counter : phaseCounters) {
+            counter.count.store(0);
+        }
+    }
+}
+
+template<class ItemType, class Compare>
+template<class InputIterator>
+ConcurrentSearchTree<ItemType, Compare>::ConcurrentSearchTree(InputIterator first, InputIterator last,
+                                                              const Compare& order)
+        : ConcurrentSearchTree(order)
+{
+    //No other thread can see the tree yet, so the writer lock is not needed
+    //(and clear(), which buildFromSorted calls, takes it itself)
+    this->buildFromSorted(first, last);
+    publish();
+}
+
+template<class ItemType, class Compare>
+bool ConcurrentSearchTree<ItemType, Compare>::add(const ItemType& newEntry) {
+    std::lock_guard<std::mutex> writerLock(writerMutex);
+    AVLTree<ItemType, Compare>::add(newEntry);
+    publish();
+    return true;
+}
+
+template<class ItemType, class Compare>
+bool ConcurrentSearchTree<ItemType, Compare>::remove(const ItemType& anEntry) {
+    std::lock_guard<std::mutex> writerLock(writerMutex);
+    //A failed search leaves copies of its path behind; they are private, so
+    //the published version is still correct
+    if (!AVLTree<ItemType, Compare>::remove(anEntry))
+        return false;
+    publish();
+    return true;
+}
+
+template<class ItemType, class Compare>
+void ConcurrentSearchTree<ItemType, Compare>::clear() {
+    std::lock_guard<std::mutex> writerLock(writerMutex);
+    AVLTree<ItemType, Compare>::clear();
+    publish();
+}
+
+template<class ItemType, class Compare>
+bool ConcurrentSearchTree<ItemType, Compare>::isEmpty() const {
+    ReadSection section(*this);
+    return section.getRoot() == nullptr;
+}
+
+template<class ItemType, class Compare>
+int ConcurrentSearchTree<ItemType, Compare>::getHeight() const {
+    ReadSection section(*this);
+    return (section.getRoot() == nullptr) ? 0 : section.getRoot()->getHeight();
+}
+
+template<class ItemType, class Compare>
+int ConcurrentSearchTree<ItemType, Compare>::getNumberOfNodes() const {
+    ReadSection section(*this);
+    return (section.getRoot() == nullptr) ? 0 : section.getRoot()->getSize();
+}
+
+template<class ItemType, class Compare>
+bool ConcurrentSearchTree<ItemType, Compare>::contains(const ItemType& anEntry) const {
+    ReadSection section(*this);
+    return findNodeIn(section.getRoot(), anEntry) != nullptr;
+}
+
+template<class ItemType, class Compare>
+ItemType ConcurrentSearchTree<ItemType, Compare>::getEntry(const ItemType& anEntry) const {
+    {
+        ReadSection section(*this);
+        const BinaryNode<ItemType>* nodePtr = findNodeIn(section.getRoot(), anEntry);
+        if (nodePtr != nullptr) {
+            return nodePtr->getItem();
+        }
+    }
+    std::string message = "Item not found within binary tree.";
+    throw(NotFoundException(message));
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Order, class>
+bool ConcurrentSearchTree<ItemType, Compare>::contains(const Key& key) const {
+    ReadSection section(*this);
+    return findNodeIn(section.getRoot(), key) != nullptr;
+}
+
+template<class ItemType, class Compare>
+template<class Key, class Order, class>
+ItemType ConcurrentSearchTree<ItemType, Compare>::getEntry(const Key& key) const {
+    {
+        ReadSection section(*this);
+        const BinaryNode<ItemType>* nodePtr = findNodeIn(section.getRoot(), key);
+        if (nodePtr != nullptr) {
+            return nodePtr->getItem();
+        }
+    }
+    std::string message = "Item not found within binary tree.";
+    throw(NotFoundException(message));
+}
+
+template<class ItemType, class Compare>
+template<class Visitor>
+void ConcurrentSearchTree<ItemType, Compare>::inorderTraverse(Visitor visit) const {
+    ReadSection section(*this);
+    this->inorderNodes(section.getRoot(), [&visit](BinaryNode<ItemType>* nodePtr) { visit(nodePtr->getItem()); });
+}
+
+#endif //CONCURRENT_SEARCH_TREE_
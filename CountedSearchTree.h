@@ -0,0 +1,278 @@
+/** AVL multiset that stores each distinct entry once, with a count.
+ Adding an entry that is already present raises its count instead of
+ adding a node, so the number of nodes and the height depend only on how
+ many distinct entries there are, however skewed the data is. remove
+ takes away one copy, and the traversals hand visit every copy, so the
+ tree holds the same entries a BinarySearchTree would.
+ @file CountedSearchTree.h */
+
+#ifndef COUNTED_SEARCH_TREE_
+#define COUNTED_SEARCH_TREE_
+
+#include <string>
+#include "BinaryTreeInterface.h"
+#include "AVLTree.h"
+#include "NotFoundException.h"
+#include "PrecondViolatedEcxcep.h"
+
+// An entry and the number of copies of it. Only the entry is compared, so
+// the count may change while the pair sits in a tree.
+template<class ItemType>
+struct CountedEntry
+{
+    ItemType item;
+    int      count;
+
+    explicit CountedEntry(const ItemType& anItem, int aCount = 1);
+
+    bool operator==(const CountedEntry<ItemType>& rightHandSide) const;
+}; // end CountedEntry
+
+// Orders counted entries by their items, and compares an item with an
+// entry directly, so a lookup by item needs no temporary entry.
+template<class ItemType>
+struct CountedOrder
+{
+    typedef void is_transparent;
+
+    DefaultOrder<ItemType> itemOrder;
+
+    bool operator()(const CountedEntry<ItemType>& leftEntry, const CountedEntry<ItemType>& rightEntry) const;
+
+    int compare(const CountedEntry<ItemType>& leftEntry, const CountedEntry<ItemType>& rightEntry) const;
+    int compare(const ItemType& leftItem, const CountedEntry<ItemType>& rightEntry) const;
+    int compare(const CountedEntry<ItemType>& leftEntry, const ItemType& rightItem) const;
+}; // end CountedOrder
+
+template<class ItemType>
+class CountedSearchTree : public BinaryTreeInterface<ItemType>
+{
+private:
+    AVLTree<CountedEntry<ItemType>, CountedOrder<ItemType>> entryTree;
+    int numberOfEntries;   // Copies of all entries
+
+public:
+    //------------------------------------------------------------
+    // Constructor Section.
+    //------------------------------------------------------------
+    CountedSearchTree();
+
+    //------------------------------------------------------------
+    // Public BinaryTreeInterface Methods Section.
+    //------------------------------------------------------------
+    bool isEmpty() const override;
+    int getHeight() const override;
+    int getNumberOfNodes() const override; // Distinct entries
+
+    ItemType getRootData() const override;
+    void setRootData(const ItemType& newData) override;
+    bool add(const ItemType& newEntry) override;
+
+    // Removes one copy of anEntry.
+    bool remove(const ItemType& anEntry) override;
+    void clear() override;
+    ItemType getEntry(const ItemType& anEntry) const override;
+    bool contains(const ItemType& anEntry) const override;
+
+    //------------------------------------------------------------
+    // Multiplicity Section.
+    //------------------------------------------------------------
+    /** @return  The number of entries, counting every copy. */
+    int getNumberOfEntries() const;
+
+    /** @return  The number of copies of anEntry; 0 if it is absent. */
+    int count(const ItemType& anEntry) const;
+
+    /** Removes every copy of anEntry.
+     @return  The number of copies removed. */
+    int removeAll(const ItemType& anEntry);
+
+    //------------------------------------------------------------
+    // Public Traversals Section.
+    // visit is called once for every copy; the copies of an entry are
+    // visited one after another, where the entry falls in the order.
+    //------------------------------------------------------------
+    void preorderTraverse(void visit(ItemType&)) const override;
+    void inorderTraverse(void visit(ItemType&)) const override;
+    void postorderTraverse(void visit(ItemType&)) const override;
+
+    // Read-only traversal that hands any callable visit the stored entry.
+    template<class Visitor, class = EnableIfConstVisitor<Visitor, ItemType>>
+    void inorderTraverse(Visitor visit) const;
+}; // end CountedSearchTree
+
+
+
+/*********************************************************************************************
+**                   Counted Entry Implementation                                           **
+*********************************************************************************************/
+template<class ItemType>
+CountedEntry<ItemType>::CountedEntry(const ItemType& anItem, int aCount)
+        : item(anItem), count(aCount)
+{ }
+
+template<class ItemType>
+bool CountedEntry<ItemType>::operator==(const CountedEntry<ItemType>& rightHandSide) const {
+    return item == rightHandSide.item;
+}
+
+template<class ItemType>
+bool CountedOrder<ItemType>::operator()(const CountedEntry<ItemType>& leftEntry,
+                                        const CountedEntry<ItemType>& rightEntry) const {
+    return itemOrder(leftEntry.item, rightEntry.item);
+}
+
+template<class ItemType>
+int CountedOrder<ItemType>::compare(const CountedEntry<ItemType>& leftEntry,
+                                    const CountedEntry<ItemType>& rightEntry) const {
+    return threeWayCompare(itemOrder, leftEntry.item, rightEntry.item, 0);
+}
+
+template<class ItemType>
+int CountedOrder<ItemType>::compare(const ItemType& leftItem, const CountedEntry<ItemType>& rightEntry) const {
+    return threeWayCompare(itemOrder, leftItem, rightEntry.item, 0);
+}
+
+template<class ItemType>
+int CountedOrder<ItemType>::compare(const CountedEntry<ItemType>& leftEntry, const ItemType& rightItem) const {
+    return threeWayCompare(itemOrder, leftEntry.item, rightItem, 0);
+}
+
+/*********************************************************************************************
+**                      Public Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType>
+CountedSearchTree<ItemType>::CountedSearchTree()
+        : numberOfEntries(0)
+{ }
+
+template<class ItemType>
+bool CountedSearchTree<ItemType>::isEmpty() const {
+    return entryTree.isEmpty();
+}
+
+template<class ItemType>
+int CountedSearchTree<ItemType>::getHeight() const {
+    return entryTree.getHeight();
+}
+
+template<class ItemType>
+int CountedSearchTree<ItemType>::getNumberOfNodes() const {
+    return entryTree.getNumberOfNodes();
+}
+
+template<class ItemType>
+ItemType CountedSearchTree<ItemType>::getRootData() const {
+    return entryTree.getRootData().item;
+}
+
+template<class ItemType>
+void CountedSearchTree<ItemType>::setRootData(const ItemType&) {
+    std::string message = "Unable to set or change root, please do not use this public method\n";
+    throw(PrecondViolatedExcep(message));
+}
+
+template<class ItemType>
+bool CountedSearchTree<ItemType>::add(const ItemType& newEntry) {
+    //One descent either raises the count or adds the first copy where it ended
+    entryTree.addOrUpdate(newEntry, [](CountedEntry<ItemType>& storedEntry) { storedEntry.count++; },
+                          [&newEntry]() { return CountedEntry<ItemType>(newEntry); });
+    numberOfEntries++;
+    return true;
+}
+
+template<class ItemType>
+bool CountedSearchTree<ItemType>::remove(const ItemType& anEntry) {
+    //Only the last copy takes its node with it
+    bool isFound = entryTree.updateOrRemove(anEntry,
+                                            [](CountedEntry<ItemType>& storedEntry) { return --storedEntry.count > 0; });
+    if (isFound) {
+        numberOfEntries--;
+    }
+    return isFound;
+}
+
+template<class ItemType>
+void CountedSearchTree<ItemType>::clear() {
+    entryTree.clear();
+    numberOfEntries = 0;
+}
+
+template<class ItemType>
+ItemType CountedSearchTree<ItemType>::getEntry(const ItemType& anEntry) const {
+    const CountedEntry<ItemType>* storedPtr = entryTree.findEntry(anEntry);
+    if (storedPtr == nullptr) {
+        std::string message = "Item not found within binary tree.";
+        throw(NotFoundException(message));
+    }
+    return storedPtr->item;
+}
+
+template<class ItemType>
+bool CountedSearchTree<ItemType>::contains(const ItemType& anEntry) const {
+    return entryTree.findEntry(anEntry) != nullptr;
+}
+
+template<class ItemType>
+int CountedSearchTree<ItemType>::getNumberOfEntries() const {
+    return numberOfEntries;
+}
+
+template<class ItemType>
+int CountedSearchTree<ItemType>::count(const ItemType& anEntry) const {
+    const CountedEntry<ItemType>* storedPtr = entryTree.findEntry(anEntry);
+    return (storedPtr == nullptr) ? 0 : storedPtr->count;
+}
+
+template<class ItemType>
+int CountedSearchTree<ItemType>::removeAll(const ItemType& anEntry) {
+    int copies = 0;
+    entryTree.updateOrRemove(anEntry, [&copies](CountedEntry<ItemType>& storedEntry) {
+        copies = storedEntry.count;
+        return false;
+    });
+    numberOfEntries -= copies;
+    return copies;
+}
+
+template<class ItemType>
+void CountedSearchTree<ItemType>::preorderTraverse(void visit(ItemType&)) const {
+    entryTree.preorderTraverse([visit](const CountedEntry<ItemType>& anEntry) {
+        for (int copy = 0; copy < anEntry.count; copy++) {
+            ItemType theItem = anEntry.item;
+            visit(theItem);
+        }
+    });
+}
+
+template<class ItemType>
+void CountedSearchTree<ItemType>::inorderTraverse(void visit(ItemType&)) const {
+    entryTree.inorderTraverse([visit](const CountedEntry<ItemType>& anEntry) {
+        for (int copy = 0; copy < anEntry.count; copy++) {
+            ItemType theItem = anEntry.item;
+            visit(theItem);
+        }
+    });
+}
+
+template<class ItemType>
+void CountedSearchTree<ItemType>::postorderTraverse(void visit(ItemType&)) const {
+    entryTree.postorderTraverse([visit](const CountedEntry<ItemType>& anEntry) {
+        for (int copy = 0; copy < anEntry.count; copy++) {
+            ItemType theItem = anEntry.item;
+            visit(theItem);
+        }
+    });
+}
+
+template<class ItemType>
+template<class Visitor, class>
+void CountedSearchTree<ItemType>::inorderTraverse(Visitor visit) const {
+    entryTree.inorderTraverse([&visit](const CountedEntry<ItemType>& anEntry) {
+        for (int copy = 0; copy < anEntry.count; copy++) {
+            visit(anEntry.item);
+        }
+    });
+}
+
+#endif //COUNTED_SEARCH_TREE_
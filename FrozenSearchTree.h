@@ -0,0 +1,244 @@
+/** Immutable, array-laid-out snapshot of a binary search tree.
+ The entries are stored in one array in Eytzinger (breadth-first) order:
+ the root is at index 1 and the children of index k are at 2k and 2k+1.
+ A lookup walks down the array with no data-dependent branches, and
+ prefetches the block of descendants a few levels ahead, so a descent
+ costs far fewer cache misses than chasing node pointers. A snapshot
+ cannot be changed; build a new one with BinarySearchTree::freeze().
+ Entries are ordered by Compare, as in BinarySearchTree.
+ @file FrozenSearchTree.h */
+
+#ifndef FROZEN_SEARCH_TREE_
+#define FROZEN_SEARCH_TREE_
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <string>
+#include "BinaryNode.h"
+#include "BinarySearchTree.h"
+#include "NotFoundException.h"
+
+template<class ItemType, class Compare>
+class FrozenSearchTree
+{
+private:
+    // items[0] is unused, so that the index arithmetic needs no offsets.
+    std::vector<ItemType> items;
+    std::size_t numberOfItems;
+    Compare comparator;
+
+    // A lookup at index k prefetches index k << PREFETCH_LEVELS, the first
+    // of the descendants that many levels down; they share one 64-byte
+    // cache line when the items are small. Larger items still look one
+    // level ahead, since a prefetch of the item being compared is wasted.
+    static const int PREFETCH_LEVELS = (sizeof(ItemType) <= 4) ? 4
+                                     : (sizeof(ItemType) <= 8) ? 3
+                                     : (sizeof(ItemType) <= 16) ? 2 : 1;
+
+protected:
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    // Index arithmetic over the implicit tree.
+    //------------------------------------------------------------
+    // Number of one bits below the lowest zero bit of index.
+    static int trailingOnes(std::size_t index);
+
+    // Index of the smallest item, or 0 if the snapshot is empty.
+    std::size_t firstIndex() const;
+
+    // Index of the item that follows the one at index in sorted order,
+    // or 0 if it is the largest.
+    std::size_t nextIndex(std::size_t index) const;
+
+    // Index of the first item that is not less than target, or 0 if
+    // every item is smaller.
+    std::size_t lowerBoundIndex(const ItemType& target) const;
+
+public:
+    //------------------------------------------------------------
+    // Constructor Section.
+    //------------------------------------------------------------
+    explicit FrozenSearchTree(const Compare& order = Compare());
+
+    /** Builds a snapshot of the entries in [first, last), ordered by order,
+        in O(n) time. Unsorted input is sorted first. */
+    template<class InputIterator>
+    FrozenSearchTree(InputIterator first, InputIterator last, const Compare& order = Compare());
+
+    //------------------------------------------------------------
+    // Public Methods Section.
+    // Same semantics as the BinarySearchTree methods of the same name.
+    //------------------------------------------------------------
+    bool isEmpty() const;
+    int getHeight() const;
+    int getNumberOfNodes() const;
+    ItemType getEntry(const ItemType& anEntry) const;
+    bool contains(const ItemType& anEntry) const;
+
+    // Returns a pointer to the stored entry matching anEntry, or nullptr.
+    // The pointer stays valid for the life of the snapshot.
+    const ItemType* findEntry(const ItemType& anEntry) const;
+
+    // Hands visit, which may be any callable, each stored entry in sorted
+    // order.
+    template<class Visitor>
+    void inorderTraverse(Visitor visit) const;
+}; // end FrozenSearchTree
+
+
+
+/*********************************************************************************************
+**                   Protected Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+int FrozenSearchTree<ItemType, Compare>::trailingOnes(std::size_t index) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(~static_cast<unsigned long long>(index));
+#else
+    int ones = 0;
+    while (index & 1) {
+        index >>= 1;
+        ones++;
+    }
+    return ones;
+#endif
+}
+
+template<class ItemType, class Compare>
+std::size_t FrozenSearchTree<ItemType, Compare>::firstIndex() const {
+    if (numberOfItems == 0)
+        return 0;
+    //Follow left children down to the bottom of the implicit tree
+    std::size_t index = 1;
+    while (2 * index <= numberOfItems) {
+        index *= 2;
+    }
+    return index;
+}
+
+template<class ItemType, class Compare>
+std::size_t FrozenSearchTree<ItemType, Compare>::nextIndex(std::size_t index) const {
+    //With a right subtree, the successor is its leftmost item
+    if (2 * index + 1 <= numberOfItems) {
+        index = 2 * index + 1;
+        while (2 * index <= numberOfItems) {
+            index *= 2;
+        }
+        return index;
+    }
+    //Otherwise climb past every right child, then one more level, to the first
+    //ancestor whose left subtree holds index
+    return index >> (trailingOnes(index) + 1);
+}
+
+template<class ItemType, class Compare>
+std::size_t FrozenSearchTree<ItemType, Compare>::lowerBoundIndex(const ItemType& target) const {
+    const ItemType* base = items.data();
+    std::size_t index = 1;
+    while (index <= numberOfItems) {
+#if defined(__GNUC__)
+        __builtin_prefetch(base + std::min(index << PREFETCH_LEVELS, numberOfItems));
+#endif
+        //Step right exactly when this item is smaller than target; the comparison
+        //result is added to the index rather than branched on
+        index = 2 * index + static_cast<std::size_t>(comparator(base[index], target));
+    }
+    //The bits of index record the path taken. The last left turn was made at the
+    //first item >= target, so drop the right turns taken after it, and it.
+    return index >> (trailingOnes(index) + 1);
+}
+
+/*********************************************************************************************
+**                      Public Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+FrozenSearchTree<ItemType, Compare>::FrozenSearchTree(const Compare& order)
+        : items(1), numberOfItems(0), comparator(order)
+{ }
+
+template<class ItemType, class Compare>
+template<class InputIterator>
+FrozenSearchTree<ItemType, Compare>::FrozenSearchTree(InputIterator first, InputIterator last, const Compare& order)
+        : comparator(order) {
+    std::vector<ItemType> sortedItems(first, last);
+    if (!std::is_sorted(sortedItems.begin(), sortedItems.end(), comparator)) {
+        std::sort(sortedItems.begin(), sortedItems.end(), comparator);
+    }
+
+    //Visiting the implicit tree inorder meets the slots in sorted order
+    numberOfItems = sortedItems.size();
+    items.resize(numberOfItems + 1);
+    std::size_t index = firstIndex();
+    for (ItemType& anItem : sortedItems) {
+        items[index] = std::move(anItem);
+        index = nextIndex(index);
+    }
+}
+
+template<class ItemType, class Compare>
+bool FrozenSearchTree<ItemType, Compare>::isEmpty() const {
+    return numberOfItems == 0;
+}
+
+template<class ItemType, class Compare>
+int FrozenSearchTree<ItemType, Compare>::getHeight() const {
+    //The implicit tree is complete, so it is as tall as its item count has bits
+    int height = 0;
+    for (std::size_t remaining = numberOfItems; remaining > 0; remaining >>= 1) {
+        height++;
+    }
+    return height;
+}
+
+template<class ItemType, class Compare>
+int FrozenSearchTree<ItemType, Compare>::getNumberOfNodes() const {
+    return static_cast<int>(numberOfItems);
+}
+
+template<class ItemType, class Compare>
+ItemType FrozenSearchTree<ItemType, Compare>::getEntry(const ItemType& anEntry) const {
+    const ItemType* storedEntry = findEntry(anEntry);
+    if (storedEntry == nullptr) {
+        std::string message = "Item not found within binary tree.";
+        throw(NotFoundException(message));
+    }
+    return *storedEntry;
+}
+
+template<class ItemType, class Compare>
+bool FrozenSearchTree<ItemType, Compare>::contains(const ItemType& anEntry) const {
+    return findEntry(anEntry) != nullptr;
+}
+
+template<class ItemType, class Compare>
+const ItemType* FrozenSearchTree<ItemType, Compare>::findEntry(const ItemType& anEntry) const {
+    //items[index] is not less than anEntry, so they match unless anEntry is less
+    std::size_t index = lowerBoundIndex(anEntry);
+    return ((index != 0) && !comparator(anEntry, items[index])) ? &items[index] : nullptr;
+}
+
+template<class ItemType, class Compare>
+template<class Visitor>
+void FrozenSearchTree<ItemType, Compare>::inorderTraverse(Visitor visit) const {
+    for (std::size_t index = firstIndex(); index != 0; index = nextIndex(index)) {
+        visit(items[index]);
+    }
+}
+
+/*********************************************************************************************
+**                   BinarySearchTree::freeze                                               **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+FrozenSearchTree<ItemType, Compare> BinarySearchTree<ItemType, Compare>::freeze() const {
+    std::vector<ItemType> sortedItems;
+    sortedItems.reserve(this->getNumberOfNodes());
+    this->inorderNodes(this->rootPtr.get(), [&sortedItems](BinaryNode<ItemType>* nodePtr) {
+        sortedItems.push_back(nodePtr->getItem());
+    });
+    return FrozenSearchTree<ItemType, Compare>(std::make_move_iterator(sortedItems.begin()),
+                                               std::make_move_iterator(sortedItems.end()), comparator);
+}
+
+#endif //FROZEN_SEARCH_TREE_
@@ -0,0 +1,69 @@
+/** Branch-free counting search over a block of sorted keys.
+ countLess(keys, count, key) returns how many of keys[0..count) are less
+ than key, which for sorted keys is the position key would be inserted at.
+ Every key is compared, so the cost does not depend on where key falls.
+ For 32-bit integer keys the comparison is done eight (AVX2) or four
+ (SSE2) keys at a time with a vector compare and a movemask; other key
+ types, and builds without those instruction sets, use the scalar loop.
+ The kernel is chosen when compiling: x86-64 builds get SSE2 by default,
+ and AVX2 only when the compiler targets it, as with -mavx2 or
+ -march=native (the TREE_NATIVE_ARCH option of CMakeLists.txt).
+ keySearchKernel() names the one that was compiled in.
+ @file KeySearch.h */
+
+#ifndef KEY_SEARCH_
+#define KEY_SEARCH_
+
+#include <cstdint>
+#if defined(__GNUC__) && (defined(__AVX2__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+
+// Names the instruction set the 32-bit kernel was compiled for.
+inline const char* keySearchKernel()
+{
+#if defined(__GNUC__) && defined(__AVX2__)
+    return "AVX2";
+#elif defined(__GNUC__) && defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}  // end keySearchKernel
+
+template<class KeyType>
+inline int countLess(const KeyType* keys, int count, const KeyType& key)
+{
+    int less = 0;
+    for (int index = 0; index < count; index++)
+        less += (key > keys[index]) ? 1 : 0;
+    return less;
+}  // end countLess
+
+inline int countLess(const std::int32_t* keys, int count, std::int32_t key)
+{
+    int less = 0;
+    int index = 0;
+#if defined(__GNUC__) && defined(__AVX2__)
+    const __m256i keyVector = _mm256_set1_epi32(key);
+    for (; index + 8 <= count; index += 8)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + index));
+        __m256i isLess = _mm256_cmpgt_epi32(keyVector, block);
+        less += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(isLess)));
+    }  // end for
+#elif defined(__GNUC__) && defined(__SSE2__)
+    const __m128i keyVector = _mm_set1_epi32(key);
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + index));
+        __m128i isLess = _mm_cmpgt_epi32(keyVector, block);
+        less += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(isLess)));
+    }  // end for
+#endif
+    for (; index < count; index++)
+        less += (key > keys[index]) ? 1 : 0;
+    return less;
+}  // end countLess
+
+#endif //KEY_SEARCH_
@@ -0,0 +1,188 @@
+/** A slab of binary tree nodes addressed by 32-bit indices.
+ Nodes live contiguously in one growable array and are linked by index
+ rather than by pointer, so a whole tree is one allocation. Freed nodes
+ are threaded onto a free list and handed out again before the slab grows.
+ A freed node keeps a live item, reset to ItemType(), so ItemType must be
+ default-constructible and copy-assignable as well as copyable.
+ @file NodePool.h */
+
+#ifndef NODE_POOL_
+#define NODE_POOL_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include "PrecondViolatedEcxcep.h"
+
+// Index value meaning "no node".
+const std::uint32_t NULL_NODE = UINT32_MAX;
+
+template<class ItemType>
+struct ArenaNode
+{
+    ItemType      item;                   // Data portion
+    std::uint32_t leftChild  = NULL_NODE; // Index of left child (next free node while on the free list)
+    std::uint32_t rightChild = NULL_NODE; // Index of right child
+    std::int32_t  height     = 1;         // Height of the subtree rooted here
+}; // end ArenaNode
+
+// Allocation counters for a NodePool.
+struct NodePoolStats
+{
+    std::size_t allocations = 0;  // Nodes handed out by allocate()
+    std::size_t frees = 0;        // Nodes returned with release()
+    std::size_t liveNodes = 0;    // Nodes currently in use
+    std::size_t peakNodes = 0;    // Largest number of nodes in use at once
+    std::size_t slabGrowths = 0;  // Times the slab had to reallocate
+    std::size_t capacity = 0;     // Nodes the slab can hold without growing
+}; // end NodePoolStats
+
+template<class ItemType>
+class NodePool
+{
+    static_assert(std::is_default_constructible<ItemType>::value && std::is_copy_assignable<ItemType>::value,
+                  "NodePool resets freed items to ItemType() and reuses them by assignment");
+
+private:
+    std::vector<ArenaNode<ItemType>> nodes;
+    std::uint32_t freeHead;
+    NodePoolStats stats;
+
+public:
+    NodePool();
+
+    /** Hands out a node holding anItem and no children.
+     @return  The index of the node.
+     @throw  PrecondViolatedExcep if every index below NULL_NODE is in use. */
+    std::uint32_t allocate(const ItemType& anItem);
+
+    /** Returns a node to the free list. Its item is reset so that any
+        resources it owns are released now rather than on reuse. */
+    void release(std::uint32_t index);
+
+    /** Releases every node at once and gives the slab back to the heap. */
+    void clear();
+
+    /** Grows the slab so that count nodes fit without reallocating. */
+    void reserve(std::size_t count);
+
+    ArenaNode<ItemType>& operator[](std::uint32_t index);
+    const ArenaNode<ItemType>& operator[](std::uint32_t index) const;
+
+    // Number of nodes currently handed out.
+    std::size_t getLiveCount() const;
+
+    NodePoolStats getStats() const;
+    void resetStats();
+}; // end NodePool
+
+
+/*******************************************************************************
+**                       IMPLEMENTATION                                       **
+*******************************************************************************/
+template<class ItemType>
+NodePool<ItemType>::NodePool()
+        : freeHead(NULL_NODE)
+{ }  // end default constructor
+
+template<class ItemType>
+std::uint32_t NodePool<ItemType>::allocate(const ItemType& anItem)
+{
+    std::uint32_t index;
+    if (freeHead != NULL_NODE)
+    {
+        index = freeHead;
+        freeHead = nodes[index].leftChild;
+        nodes[index].item = anItem;
+    }
+    else
+    {
+        if (nodes.size() >= NULL_NODE)
+        {
+            std::string message = "NodePool cannot address more than " + std::to_string(NULL_NODE) + " nodes.";
+            throw(PrecondViolatedExcep(message));
+        }  // end if
+        if (nodes.size() == nodes.capacity())
+            stats.slabGrowths++;
+        index = static_cast<std::uint32_t>(nodes.size());
+        nodes.push_back(ArenaNode<ItemType>{anItem});
+    }  // end if
+
+    nodes[index].leftChild = NULL_NODE;
+    nodes[index].rightChild = NULL_NODE;
+    nodes[index].height = 1;
+    stats.allocations++;
+    stats.liveNodes++;
+    if (stats.liveNodes > stats.peakNodes)
+        stats.peakNodes = stats.liveNodes;
+    return index;
+}  // end allocate
+
+template<class ItemType>
+void NodePool<ItemType>::release(std::uint32_t index)
+{
+    nodes[index].item = ItemType();
+    nodes[index].leftChild = freeHead;
+    nodes[index].rightChild = NULL_NODE;
+    freeHead = index;
+    stats.frees++;
+    stats.liveNodes--;
+}  // end release
+
+template<class ItemType>
+void NodePool<ItemType>::clear()
+{
+    stats.frees += stats.liveNodes;
+    stats.liveNodes = 0;
+    std::vector<ArenaNode<ItemType>>().swap(nodes);
+    freeHead = NULL_NODE;
+}  // end clear
+
+template<class ItemType>
+void NodePool<ItemType>::reserve(std::size_t count)
+{
+    if (count > nodes.capacity())
+    {
+        stats.slabGrowths++;
+        nodes.reserve(count);
+    }  // end if
+}  // end reserve
+
+template<class ItemType>
+ArenaNode<ItemType>& NodePool<ItemType>::operator[](std::uint32_t index)
+{
+    return nodes[index];
+}  // end operator[]
+
+template<class ItemType>
+const ArenaNode<ItemType>& NodePool<ItemType>::operator[](std::uint32_t index) const
+{
+    return nodes[index];
+}  // end operator[]
+
+template<class ItemType>
+std::size_t NodePool<ItemType>::getLiveCount() const
+{
+    return stats.liveNodes;
+}  // end getLiveCount
+
+template<class ItemType>
+NodePoolStats NodePool<ItemType>::getStats() const
+{
+    NodePoolStats current = stats;
+    current.capacity = nodes.capacity();
+    return current;
+}  // end getStats
+
+template<class ItemType>
+void NodePool<ItemType>::resetStats()
+{
+    std::size_t live = stats.liveNodes;
+    stats = NodePoolStats();
+    stats.liveNodes = live;
+    stats.peakNodes = live;
+}  // end resetStats
+
+#endif //NODE_POOL_
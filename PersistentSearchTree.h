@@ -0,0 +1,133 @@
+/** AVL tree whose copies share structure instead of copying nodes.
+ Copying a PersistentSearchTree takes O(1) time: both copies point at the
+ same nodes. A node reachable from more than one version is never changed
+ in place; an add or remove first replaces each such node on its path
+ with a private copy, so a change costs O(log n) new nodes and every
+ other version keeps seeing exactly the entries it had. added() and
+ removed() return the changed tree as a new version and leave this one
+ as it was. Versions are not safe to use from several threads at once;
+ see ConcurrentSearchTree for that. Entries are ordered by Compare, as
+ in BinarySearchTree, and every version keeps its tree's ordering.
+ @file PersistentSearchTree.h */
+
+#ifndef PERSISTENT_SEARCH_TREE_
+#define PERSISTENT_SEARCH_TREE_
+
+#include <memory>
+#include "BinaryNode.h"
+#include "AVLTree.h"
+
+template<class ItemType, class Compare = DefaultOrder<ItemType>>
+class PersistentSearchTree : public AVLTree<ItemType, Compare>
+{
+protected:
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    //------------------------------------------------------------
+    // A node that is also owned by another link belongs to another
+    // version as well, so it is replaced with a private copy.
+    void detachLink(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink) override;
+
+    bool sharesNodes() const override;
+
+public:
+    //------------------------------------------------------------
+    // Constructor Section.
+    //------------------------------------------------------------
+    PersistentSearchTree() = default;
+
+    // Creates an empty tree whose entries are ordered by order.
+    explicit PersistentSearchTree(const Compare& order);
+
+    // Builds a balanced tree of the entries in [first, last); see
+    // BinarySearchTree::buildFromSorted.
+    template<class InputIterator>
+    PersistentSearchTree(InputIterator first, InputIterator last, const Compare& order = Compare());
+
+    // Takes a snapshot in O(1) time, sharing every node with tree.
+    PersistentSearchTree(const PersistentSearchTree<ItemType, Compare>& tree);
+    PersistentSearchTree& operator=(const PersistentSearchTree<ItemType, Compare>& rightHandSide);
+
+    //------------------------------------------------------------
+    // Version Section.
+    //------------------------------------------------------------
+    /** @return  A new version that also holds newEntry. This version is
+        unchanged, and the two share all but O(log n) nodes. */
+    PersistentSearchTree<ItemType, Compare> added(const ItemType& newEntry) const;
+
+    /** @return  A new version without one occurrence of anEntry, or an
+        equal version if anEntry is absent. This version is unchanged. */
+    PersistentSearchTree<ItemType, Compare> removed(const ItemType& anEntry) const;
+}; // end PersistentSearchTree
+
+
+
+/*********************************************************************************************
+**                   Protected Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+void PersistentSearchTree<ItemType, Compare>::detachLink(std::shared_ptr<BinaryNode<ItemType>>& subTreeLink) {
+    //The copy shares the children, so the walk detaches them in turn as it goes down
+    if ((subTreeLink != nullptr) && (subTreeLink.use_count() > 1)) {
+        subTreeLink = std::make_shared<BinaryNode<ItemType>>(*subTreeLink);
+    }
+}
+
+template<class ItemType, class Compare>
+bool PersistentSearchTree<ItemType, Compare>::sharesNodes() const {
+    return true;
+}
+
+/*********************************************************************************************
+**                      Public Method Implementations                                       **
+*********************************************************************************************/
+template<class ItemType, class Compare>
+PersistentSearchTree<ItemType, Compare>::PersistentSearchTree(const Compare& order)
+        : AVLTree<ItemType, Compare>(order)
+{
+}
+
+template<class ItemType, class Compare>
+template<class InputIterator>
+PersistentSearchTree<ItemType, Compare>::PersistentSearchTree(InputIterator first, InputIterator last,
+                                                              const Compare& order)
+        : AVLTree<ItemType, Compare>(order)
+{
+    this->buildFromSorted(first, last);
+}
+
+template<class ItemType, class Compare>
+PersistentSearchTree<ItemType, Compare>::PersistentSearchTree(const PersistentSearchTree<ItemType, Compare>& tree)
+        : AVLTree<ItemType, Compare>(tree.comparator)
+{
+    this->rootPtr = tree.rootPtr;
+}
+
+template<class ItemType, class Compare>
+PersistentSearchTree<ItemType, Compare>& PersistentSearchTree<ItemType, Compare>::operator=(
+        const PersistentSearchTree<ItemType, Compare>& rightHandSide) {
+    if (this != &rightHandSide) {
+        //Take the new root first, so nodes both versions share are not released
+        std::shared_ptr<BinaryNode<ItemType>> oldRootPtr = std::move(this->rootPtr);
+        this->rootPtr = rightHandSide.rootPtr;
+        this->comparator = rightHandSide.comparator;
+        this->destroyTree(oldRootPtr);
+    }
+    return *this;
+}
+
+template<class ItemType, class Compare>
+PersistentSearchTree<ItemType, Compare> PersistentSearchTree<ItemType, Compare>::added(const ItemType& newEntry) const {
+    PersistentSearchTree<ItemType, Compare> newVersion(*this);
+    newVersion.add(newEntry);
+    return newVersion;
+}
+
+template<class ItemType, class Compare>
+PersistentSearchTree<ItemType, Compare> PersistentSearchTree<ItemType, Compare>::removed(const ItemType& anEntry) const {
+    PersistentSearchTree<ItemType, Compare> newVersion(*this);
+    newVersion.remove(anEntry);
+    return newVersion;
+}
+
+#endif //PERSISTENT_SEARCH_TREE_
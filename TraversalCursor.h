@@ -0,0 +1,138 @@
+/** Pull-based preorder, inorder or postorder walk over a tree of
+ BinaryNodes. Each call to next() returns one item and does only the work
+ needed to reach it, so a caller that stops after k items pays for k
+ items, and two cursors can be advanced in step to interleave two trees.
+ The cursor keeps one explicit stack of at most height nodes. Changing
+ the tree while a cursor is open invalidates the cursor.
+ @file TraversalCursor.h */
+
+#ifndef TRAVERSAL_CURSOR_
+#define TRAVERSAL_CURSOR_
+
+#include <vector>
+#include <string>
+#include "BinaryNode.h"
+#include "PrecondViolatedEcxcep.h"
+
+enum class TraversalOrder { PREORDER, INORDER, POSTORDER };
+
+template<class ItemType>
+class TraversalCursor
+{
+private:
+    TraversalOrder order;
+
+    // The top node is always the next one to be returned.
+    std::vector<const BinaryNode<ItemType>*> nodeStack;
+
+    // Pushes subTreePtr and its left spine; the last node pushed is the
+    // first of the subtree in inorder.
+    void pushLeftSpine(const BinaryNode<ItemType>* subTreePtr);
+
+    // Pushes the path from subTreePtr down to the first node of the
+    // subtree in postorder, taking the left child wherever there is one.
+    void pushFirstPostorder(const BinaryNode<ItemType>* subTreePtr);
+
+public:
+    /** Starts a walk in the given order over the tree rooted at rootPtr. */
+    TraversalCursor(const BinaryNode<ItemType>* rootPtr, TraversalOrder traversalOrder);
+
+    /** @return  True if next() has an item to return. */
+    bool hasNext() const;
+
+    /** Returns the next item without moving past it.
+     @pre  hasNext() is true.
+     @throw  PrecondViolatedExcep if the walk is finished. */
+    const ItemType& peek() const;
+
+    /** Returns the next item and moves past it, in O(1) amortized time.
+     @pre  hasNext() is true.
+     @throw  PrecondViolatedExcep if the walk is finished. */
+    const ItemType& next();
+}; // end TraversalCursor
+
+template<class ItemType>
+TraversalCursor<ItemType>::TraversalCursor(const BinaryNode<ItemType>* rootPtr, TraversalOrder traversalOrder)
+        : order(traversalOrder)
+{
+    if (rootPtr == nullptr)
+        return;
+    nodeStack.reserve(rootPtr->getHeight());
+    if (order == TraversalOrder::PREORDER)
+        nodeStack.push_back(rootPtr);
+    else if (order == TraversalOrder::INORDER)
+        pushLeftSpine(rootPtr);
+    else
+        pushFirstPostorder(rootPtr);
+}  // end constructor
+
+template<class ItemType>
+void TraversalCursor<ItemType>::pushLeftSpine(const BinaryNode<ItemType>* subTreePtr)
+{
+    for (; subTreePtr != nullptr; subTreePtr = subTreePtr->getLeftChildPtr().get())
+        nodeStack.push_back(subTreePtr);
+}  // end pushLeftSpine
+
+template<class ItemType>
+void TraversalCursor<ItemType>::pushFirstPostorder(const BinaryNode<ItemType>* subTreePtr)
+{
+    while (subTreePtr != nullptr)
+    {
+        nodeStack.push_back(subTreePtr);
+        subTreePtr = (subTreePtr->getLeftChildPtr() != nullptr) ? subTreePtr->getLeftChildPtr().get()
+                                                                : subTreePtr->getRightChildPtr().get();
+    }  // end while
+}  // end pushFirstPostorder
+
+template<class ItemType>
+bool TraversalCursor<ItemType>::hasNext() const
+{
+    return !nodeStack.empty();
+}  // end hasNext
+
+template<class ItemType>
+const ItemType& TraversalCursor<ItemType>::peek() const
+{
+    if (nodeStack.empty())
+    {
+        std::string message = "peek() called after the traversal finished.";
+        throw(PrecondViolatedExcep(message));
+    }  // end if
+    return nodeStack.back()->getItem();
+}  // end peek
+
+template<class ItemType>
+const ItemType& TraversalCursor<ItemType>::next()
+{
+    if (nodeStack.empty())
+    {
+        std::string message = "next() called after the traversal finished.";
+        throw(PrecondViolatedExcep(message));
+    }  // end if
+    const BinaryNode<ItemType>* nodePtr = nodeStack.back();
+    nodeStack.pop_back();
+
+    if (order == TraversalOrder::PREORDER)
+    {
+        // The right child waits below the left one, so at most one pending
+        // right child is stacked per level
+        if (nodePtr->getRightChildPtr() != nullptr)
+            nodeStack.push_back(nodePtr->getRightChildPtr().get());
+        if (nodePtr->getLeftChildPtr() != nullptr)
+            nodeStack.push_back(nodePtr->getLeftChildPtr().get());
+    }
+    else if (order == TraversalOrder::INORDER)
+    {
+        pushLeftSpine(nodePtr->getRightChildPtr().get());
+    }
+    else if (!nodeStack.empty())
+    {
+        // Leaving a left subtree: the parent's right subtree comes before the parent
+        const BinaryNode<ItemType>* parentPtr = nodeStack.back();
+        if (parentPtr->getLeftChildPtr().get() == nodePtr)
+            pushFirstPostorder(parentPtr->getRightChildPtr().get());
+    }  // end if
+    return nodePtr->getItem();
+}  // end next
+
+#endif //TRAVERSAL_CURSOR_
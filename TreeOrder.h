@@ -0,0 +1,110 @@
+/** Orderings for BinarySearchTree and AVLTree.
+ An ordering is a function object whose order(a, b) is true when a comes
+ before b, as std::less is. A search asks it for a three-way answer
+ through threeWayCompare, and what that costs depends on the ordering:
+   - an ordering that has a member compare(a, b), returning a negative,
+     zero or positive int, is called once per node;
+   - DefaultOrder<std::string> and std::less<std::string> are answered
+     with one std::string::compare;
+   - arithmetic items under DefaultOrder, std::less or std::greater are
+     compared with two machine comparisons and no branch;
+   - any other ordering is called as order(a, b) and, unless that is
+     true, once more as order(b, a), so a search may compare two items
+     twice per node. Give an ItemType that is costly to compare an
+     ordering with compare() to avoid that.
+
+ An ordering that declares is_transparent, as DefaultOrder<void> does,
+ lets the trees look entries up by any key it can compare with ItemType,
+ without building an ItemType.
+
+ The ordered searches use only the ordering, but BinaryNodeTree's
+ unordered searches, which every tree inherits, still match items with
+ ==, so ItemType must have it.
+ @file TreeOrder.h */
+
+#ifndef TREE_ORDER_
+#define TREE_ORDER_
+
+#include <functional>
+#include <string>
+#include <type_traits>
+
+// The default ordering: the > operator that the trees have always
+// required of ItemType, so existing item types keep working.
+template<class ItemType = void>
+struct DefaultOrder
+{
+    bool operator()(const ItemType& leftItem, const ItemType& rightItem) const
+    {
+        return rightItem > leftItem;
+    }
+}; // end DefaultOrder
+
+// Transparent form of DefaultOrder: compares any two types for which >
+// is defined, in both orders.
+template<>
+struct DefaultOrder<void>
+{
+    typedef void is_transparent;
+
+    template<class Left, class Right>
+    bool operator()(const Left& leftItem, const Right& rightItem) const
+    {
+        return rightItem > leftItem;
+    }
+}; // end DefaultOrder<void>
+
+/** Compares leftItem with rightItem under order.
+ Call with a last argument of 0, which picks order.compare when the
+ ordering has it.
+ @return  Negative if leftItem comes first, positive if rightItem does,
+    and zero if neither does. */
+template<class Order, class Left, class Right>
+auto threeWayCompare(const Order& order, const Left& leftItem, const Right& rightItem, int)
+        -> decltype(static_cast<int>(order.compare(leftItem, rightItem)))
+{
+    return static_cast<int>(order.compare(leftItem, rightItem));
+}  // end threeWayCompare
+
+template<class Order, class Left, class Right>
+int threeWayCompare(const Order& order, const Left& leftItem, const Right& rightItem, long)
+{
+    return order(leftItem, rightItem) ? -1 : (order(rightItem, leftItem) ? 1 : 0);
+}  // end threeWayCompare
+
+// The standard orderings of arithmetic items: both answers are taken at
+// once, so the search does not branch between them.
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value, int>::type
+threeWayCompare(const DefaultOrder<ItemType>&, const ItemType& leftItem, const ItemType& rightItem, int)
+{
+    return static_cast<int>(leftItem > rightItem) - static_cast<int>(rightItem > leftItem);
+}  // end threeWayCompare
+
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value, int>::type
+threeWayCompare(const std::less<ItemType>&, const ItemType& leftItem, const ItemType& rightItem, int)
+{
+    return static_cast<int>(rightItem < leftItem) - static_cast<int>(leftItem < rightItem);
+}  // end threeWayCompare
+
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value, int>::type
+threeWayCompare(const std::greater<ItemType>&, const ItemType& leftItem, const ItemType& rightItem, int)
+{
+    return static_cast<int>(leftItem < rightItem) - static_cast<int>(rightItem < leftItem);
+}  // end threeWayCompare
+
+inline int threeWayCompare(const DefaultOrder<std::string>&, const std::string& leftItem,
+                           const std::string& rightItem, int)
+{
+    return leftItem.compare(rightItem);
+}  // end threeWayCompare
+
+inline int threeWayCompare(const std::less<std::string>&, const std::string& leftItem, const std::string& rightItem,
+                           int)
+{
+    return leftItem.compare(rightItem);
+}  // end threeWayCompare
+
+#endif //TREE_ORDER_
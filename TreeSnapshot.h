@@ -0,0 +1,307 @@
+/** On-disk snapshots of a tree's entries, and zero-parse loading by mmap.
+ A snapshot file is a 64-byte header followed by the entries in sorted
+ order, stored as raw bytes, so ItemType must be trivially copyable. The
+ header holds a magic string, a format version, the size of one entry,
+ the number of entries and a checksum of the entries. Files are written
+ and read in the machine's own byte order.
+
+ MappedSnapshot maps a file into memory and checks its header, and then
+ serves lookups by binary search straight from the mapping, ordered by
+ its Compare, which must be the ordering of the tree that was written.
+ When it verifies the checksum it also checks that the entries are in
+ that order, so a file mapped with the wrong ordering is refused rather
+ than searched wrongly. Its begin()
+ and end() can also be handed to BinarySearchTree::buildFromSorted,
+ which sees that the entries are sorted and builds the tree in O(n).
+ Where mmap is not available the file is read into memory instead.
+ @file TreeSnapshot.h */
+
+#ifndef TREE_SNAPSHOT_
+#define TREE_SNAPSHOT_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "BinarySearchTree.h"
+#include "TreeOrder.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TREE_SNAPSHOT_MMAP 1
+#endif
+
+// Bumped whenever the layout of a snapshot file changes.
+const std::uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+// The entries start this many bytes into the file, so a mapped file
+// keeps them aligned for any ItemType.
+const std::size_t SNAPSHOT_HEADER_BYTES = 64;
+
+struct SnapshotHeader
+{
+    char          magic[8];        // "BSTSNAP" and a terminating zero
+    std::uint32_t formatVersion;
+    std::uint32_t itemBytes;       // sizeof(ItemType) of the writer
+    std::uint64_t itemCount;
+    std::uint64_t checksum;        // snapshotChecksum() of the entry bytes
+    unsigned char reserved[SNAPSHOT_HEADER_BYTES - 32];
+}; // end SnapshotHeader
+
+static_assert(sizeof(SnapshotHeader) == SNAPSHOT_HEADER_BYTES, "the header must fill its 64 bytes exactly");
+
+// Folds byteCount bytes into a running 64-bit FNV-1a style checksum,
+// eight bytes at a time. Start from SNAPSHOT_CHECKSUM_SEED.
+const std::uint64_t SNAPSHOT_CHECKSUM_SEED = 14695981039346656037ULL;
+
+inline std::uint64_t snapshotChecksum(std::uint64_t checksum, const unsigned char* bytes, std::size_t byteCount)
+{
+    const std::uint64_t prime = 1099511628211ULL;
+    std::size_t index = 0;
+    for (; index + 8 <= byteCount; index += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + index, 8);
+        checksum = (checksum ^ word) * prime;
+    }  // end for
+    for (; index < byteCount; index++)
+        checksum = (checksum ^ bytes[index]) * prime;
+    return checksum;
+}  // end snapshotChecksum
+
+/** Writes the entries of tree, in sorted order, to a snapshot file.
+ Map it with a MappedSnapshot of the same Compare.
+ @throw  std::runtime_error if the file cannot be written. */
+template<class ItemType, class Compare>
+void writeSnapshot(const BinarySearchTree<ItemType, Compare>& tree, const std::string& fileName)
+{
+    static_assert(std::is_trivially_copyable<ItemType>::value, "snapshots store entries as raw bytes");
+    std::ofstream output(fileName, std::ios::binary | std::ios::trunc);
+    if (!output)
+        throw std::runtime_error("Unable to open snapshot file " + fileName + " for writing.");
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "BSTSNAP", 8);
+    header.formatVersion = SNAPSHOT_FORMAT_VERSION;
+    header.itemBytes = sizeof(ItemType);
+    header.itemCount = static_cast<std::uint64_t>(tree.getNumberOfNodes());
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Entries go out through a buffer of about 1 MB; the checksum is taken
+    // as each buffer is flushed
+    std::vector<ItemType> buffer;
+    buffer.reserve(std::max<std::size_t>(1, (1 << 20) / sizeof(ItemType)));
+    std::uint64_t checksum = SNAPSHOT_CHECKSUM_SEED;
+    auto flush = [&output, &buffer, &checksum]()
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(buffer.data());
+        checksum = snapshotChecksum(checksum, bytes, buffer.size() * sizeof(ItemType));
+        output.write(reinterpret_cast<const char*>(bytes), buffer.size() * sizeof(ItemType));
+        buffer.clear();
+    };
+    tree.inorderTraverse([&buffer, &flush](const ItemType& anEntry)
+    {
+        buffer.push_back(anEntry);
+        if (buffer.size() == buffer.capacity())
+            flush();
+    });
+    flush();
+
+    header.checksum = checksum;
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!output)
+        throw std::runtime_error("Unable to write snapshot file " + fileName + ".");
+}  // end writeSnapshot
+
+template<class ItemType, class Compare = DefaultOrder<ItemType>>
+class MappedSnapshot
+{
+private:
+    const unsigned char* fileBytes;   // The whole file
+    std::size_t fileSize;
+    const ItemType* items;
+    std::size_t numberOfItems;
+    Compare comparator;
+#if !defined(TREE_SNAPSHOT_MMAP)
+    std::vector<unsigned char> fileCopy;
+#endif
+
+    // Checks the header, and the checksum and the order of the entries if
+    // asked, then points items at the entries.
+    void validate(const std::string& fileName, bool verifyChecksum);
+
+    void release();
+
+public:
+    /** Maps a snapshot file written by writeSnapshot.
+     @param verifyChecksum  Whether to recompute the checksum and check
+        that the entries are sorted by order, which reads every entry once;
+        the header is always checked.
+     @param order  The ordering of the tree the snapshot was written from.
+     @pre  Without verifyChecksum, the entries must be sorted by order, or
+        lookups give wrong answers.
+     @throw  std::runtime_error if the file cannot be read, or is not a
+        snapshot of this ItemType, or fails the checksum or the order check. */
+    explicit MappedSnapshot(const std::string& fileName, bool verifyChecksum = true,
+                            const Compare& order = Compare());
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot<ItemType, Compare>& snapshot) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot<ItemType, Compare>& rightHandSide) = delete;
+
+    int getNumberOfNodes() const;
+
+    // The entries in sorted order; valid for the life of the snapshot.
+    const ItemType* begin() const;
+    const ItemType* end() const;
+
+    // Binary searches over the mapped entries, with the semantics of the
+    // BinarySearchTree methods of the same name.
+    bool contains(const ItemType& anEntry) const;
+    const ItemType* findEntry(const ItemType& anEntry) const;
+}; // end MappedSnapshot
+
+template<class ItemType, class Compare>
+MappedSnapshot<ItemType, Compare>::MappedSnapshot(const std::string& fileName, bool verifyChecksum,
+                                                  const Compare& order)
+        : fileBytes(nullptr), fileSize(0), items(nullptr), numberOfItems(0), comparator(order)
+{
+    static_assert(std::is_trivially_copyable<ItemType>::value, "snapshots store entries as raw bytes");
+    static_assert(alignof(ItemType) <= SNAPSHOT_HEADER_BYTES, "entries must be aligned by the header size");
+#if defined(TREE_SNAPSHOT_MMAP)
+    int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+        throw std::runtime_error("Unable to open snapshot file " + fileName + ".");
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) == 0)
+        fileSize = static_cast<std::size_t>(fileStatus.st_size);
+    void* mapping = (fileSize > 0) ? mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) : MAP_FAILED;
+    close(fileDescriptor);  // The mapping stays valid without the descriptor
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("Unable to map snapshot file " + fileName + ".");
+    fileBytes = static_cast<const unsigned char*>(mapping);
+#else
+    std::ifstream input(fileName, std::ios::binary);
+    if (!input)
+        throw std::runtime_error("Unable to open snapshot file " + fileName + ".");
+    fileCopy.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    fileBytes = fileCopy.data();
+    fileSize = fileCopy.size();
+#endif
+    try
+    {
+        validate(fileName, verifyChecksum);
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }  // end try
+}  // end constructor
+
+template<class ItemType, class Compare>
+MappedSnapshot<ItemType, Compare>::~MappedSnapshot()
+{
+    release();
+}  // end destructor
+
+template<class ItemType, class Compare>
+void MappedSnapshot<ItemType, Compare>::release()
+{
+#if defined(TREE_SNAPSHOT_MMAP)
+    if (fileBytes != nullptr)
+        munmap(const_cast<unsigned char*>(fileBytes), fileSize);
+#endif
+    fileBytes = nullptr;
+}  // end release
+
+template<class ItemType, class Compare>
+void MappedSnapshot<ItemType, Compare>::validate(const std::string& fileName, bool verifyChecksum)
+{
+    SnapshotHeader header;
+    if (fileSize < sizeof(header))
+        throw std::runtime_error(fileName + " is too short to be a snapshot.");
+    std::memcpy(&header, fileBytes, sizeof(header));
+    if (std::memcmp(header.magic, "BSTSNAP", 8) != 0)
+        throw std::runtime_error(fileName + " is not a snapshot file.");
+    if (header.formatVersion != SNAPSHOT_FORMAT_VERSION)
+        throw std::runtime_error(fileName + " has snapshot format version " + std::to_string(header.formatVersion)
+                                 + "; expected " + std::to_string(SNAPSHOT_FORMAT_VERSION) + ".");
+    if (header.itemBytes != sizeof(ItemType))
+        throw std::runtime_error(fileName + " holds entries of " + std::to_string(header.itemBytes) + " bytes; expected "
+                                 + std::to_string(sizeof(ItemType)) + ".");
+    if ((fileSize - sizeof(header)) / sizeof(ItemType) < header.itemCount)
+        throw std::runtime_error(fileName + " is shorter than its header says.");
+
+    items = reinterpret_cast<const ItemType*>(fileBytes + sizeof(header));
+    numberOfItems = static_cast<std::size_t>(header.itemCount);
+    if (verifyChecksum
+        && (snapshotChecksum(SNAPSHOT_CHECKSUM_SEED, fileBytes + sizeof(header), numberOfItems * sizeof(ItemType))
+            != header.checksum))
+        throw std::runtime_error(fileName + " fails its checksum.");
+    if (verifyChecksum)
+    {
+        for (std::size_t index = 1; index < numberOfItems; index++)
+        {
+            if (comparator(items[index], items[index - 1]))
+                throw std::runtime_error(fileName + " is not sorted by this snapshot's ordering.");
+        }  // end for
+    }  // end if
+}  // end validate
+
+template<class ItemType, class Compare>
+int MappedSnapshot<ItemType, Compare>::getNumberOfNodes() const
+{
+    return static_cast<int>(numberOfItems);
+}  // end getNumberOfNodes
+
+template<class ItemType, class Compare>
+const ItemType* MappedSnapshot<ItemType, Compare>::begin() const
+{
+    return items;
+}  // end begin
+
+template<class ItemType, class Compare>
+const ItemType* MappedSnapshot<ItemType, Compare>::end() const
+{
+    return items + numberOfItems;
+}  // end end
+
+template<class ItemType, class Compare>
+bool MappedSnapshot<ItemType, Compare>::contains(const ItemType& anEntry) const
+{
+    return findEntry(anEntry) != nullptr;
+}  // end contains
+
+template<class ItemType, class Compare>
+const ItemType* MappedSnapshot<ItemType, Compare>::findEntry(const ItemType& anEntry) const
+{
+    // Halve [first, first + length) until it holds only the first entry >= anEntry
+    const ItemType* first = items;
+    std::size_t length = numberOfItems;
+    while (length > 0)
+    {
+        std::size_t half = length / 2;
+        if (comparator(first[half], anEntry))
+        {
+            first += half + 1;
+            length -= half + 1;
+        }
+        else
+            length = half;
+    }  // end while
+    // *first is not less than anEntry, so they match unless anEntry is less
+    return ((first != end()) && !comparator(anEntry, *first)) ? first : nullptr;
+}  // end findEntry
+
+#endif //TREE_SNAPSHOT_
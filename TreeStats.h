@@ -0,0 +1,214 @@
+/** Optional operation counters for the link-based trees.
+ Define BINARY_TREE_STATS before including any tree header to compile
+ the counters in. BinaryNodeTree and BinarySearchTree then count the
+ comparisons made and the nodes visited by their searches, the depth each
+ search reached, and the nodes visited by traversals, and BinaryNode
+ counts every node constructed and destroyed. getStats() and resetStats()
+ on a tree read and restart its counters at run time.
+
+ Without BINARY_TREE_STATS the trees carry no counters at all: every
+ counting call goes to an empty inline StatsProbe, which the compiler
+ removes, and getStats() returns zeros with enabled set to false.
+ @file TreeStats.h */
+
+#ifndef TREE_STATS_
+#define TREE_STATS_
+
+#include <cstddef>
+#include <vector>
+#if defined(BINARY_TREE_STATS)
+#include <atomic>
+#endif
+
+// Searches that reach this depth or deeper share the last histogram bucket.
+const std::size_t TREE_STATS_MAX_DEPTH = 64;
+
+// A copy of a tree's counters at one moment.
+struct TreeStats
+{
+    bool      enabled;          // Whether BINARY_TREE_STATS was defined
+    long long searches;         // Descents made by add, remove and lookups
+    long long comparisons;      // Item comparisons made by those descents
+    long long nodesVisited;     // Nodes reached by descents and traversals
+    long long nodesAllocated;   // BinaryNodes constructed, by any tree, since the reset
+    long long nodesFreed;       // BinaryNodes destroyed, by any tree, since the reset
+
+    // depthHistogram[d] is the number of searches that looked at d nodes
+    // before they stopped; the last bucket also holds deeper searches.
+    std::vector<long long> depthHistogram;
+
+    TreeStats();
+
+    // Mean number of nodes a search looked at; 0 if there were none.
+    double averageDepth() const;
+}; // end TreeStats
+
+inline TreeStats::TreeStats()
+        : enabled(false), searches(0), comparisons(0), nodesVisited(0), nodesAllocated(0), nodesFreed(0),
+          depthHistogram(TREE_STATS_MAX_DEPTH + 1, 0)
+{ }  // end constructor
+
+inline double TreeStats::averageDepth() const
+{
+    long long totalDepth = 0;
+    for (std::size_t depth = 0; depth < depthHistogram.size(); depth++)
+        totalDepth += static_cast<long long>(depth) * depthHistogram[depth];
+    return (searches == 0) ? 0.0 : static_cast<double>(totalDepth) / searches;
+}  // end averageDepth
+
+#if defined(BINARY_TREE_STATS)
+
+// Process-wide counts of BinaryNodes, kept by a NodeTally in every node.
+// Nodes may be shared between trees, so they cannot be charged to one.
+struct NodeCounts
+{
+    std::atomic<long long> constructed;
+    std::atomic<long long> destroyed;
+}; // end NodeCounts
+
+inline NodeCounts& nodeCounts()
+{
+    static NodeCounts counts{{0}, {0}};
+    return counts;
+}  // end nodeCounts
+
+// Member of BinaryNode that counts node lifetimes, including copies.
+struct NodeTally
+{
+    NodeTally() { nodeCounts().constructed.fetch_add(1, std::memory_order_relaxed); }
+    NodeTally(const NodeTally&) : NodeTally() { }
+    NodeTally& operator=(const NodeTally&) { return *this; }
+    ~NodeTally() { nodeCounts().destroyed.fetch_add(1, std::memory_order_relaxed); }
+}; // end NodeTally
+
+// The counters of one tree. Const searches may run on several threads at
+// once, so the counters are relaxed atomics. A copied tree starts with
+// fresh counters.
+class TreeStatsCounters
+{
+private:
+    std::atomic<long long> searches;
+    std::atomic<long long> comparisons;
+    std::atomic<long long> nodesVisited;
+    std::atomic<long long> depthHistogram[TREE_STATS_MAX_DEPTH + 1];
+    long long constructedAtReset;
+    long long destroyedAtReset;
+
+public:
+    TreeStatsCounters();
+    TreeStatsCounters(const TreeStatsCounters&);
+    TreeStatsCounters& operator=(const TreeStatsCounters&);
+
+    void addSearch(long long searchComparisons, long long depth);
+    void addVisits(long long visits);
+
+    TreeStats snapshot() const;
+    void reset();
+}; // end TreeStatsCounters
+
+inline TreeStatsCounters::TreeStatsCounters()
+{
+    reset();
+}  // end default constructor
+
+inline TreeStatsCounters::TreeStatsCounters(const TreeStatsCounters&)
+{
+    reset();
+}  // end copy constructor
+
+inline TreeStatsCounters& TreeStatsCounters::operator=(const TreeStatsCounters&)
+{
+    return *this;
+}  // end operator=
+
+inline void TreeStatsCounters::addSearch(long long searchComparisons, long long depth)
+{
+    std::size_t bucket = (depth < static_cast<long long>(TREE_STATS_MAX_DEPTH))
+                         ? static_cast<std::size_t>(depth) : TREE_STATS_MAX_DEPTH;
+    searches.fetch_add(1, std::memory_order_relaxed);
+    comparisons.fetch_add(searchComparisons, std::memory_order_relaxed);
+    nodesVisited.fetch_add(depth, std::memory_order_relaxed);
+    depthHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}  // end addSearch
+
+inline void TreeStatsCounters::addVisits(long long visits)
+{
+    nodesVisited.fetch_add(visits, std::memory_order_relaxed);
+}  // end addVisits
+
+inline TreeStats TreeStatsCounters::snapshot() const
+{
+    TreeStats stats;
+    stats.enabled = true;
+    stats.searches = searches.load(std::memory_order_relaxed);
+    stats.comparisons = comparisons.load(std::memory_order_relaxed);
+    stats.nodesVisited = nodesVisited.load(std::memory_order_relaxed);
+    stats.nodesAllocated = nodeCounts().constructed.load(std::memory_order_relaxed) - constructedAtReset;
+    stats.nodesFreed = nodeCounts().destroyed.load(std::memory_order_relaxed) - destroyedAtReset;
+    for (std::size_t depth = 0; depth <= TREE_STATS_MAX_DEPTH; depth++)
+        stats.depthHistogram[depth] = depthHistogram[depth].load(std::memory_order_relaxed);
+    return stats;
+}  // end snapshot
+
+inline void TreeStatsCounters::reset()
+{
+    searches.store(0, std::memory_order_relaxed);
+    comparisons.store(0, std::memory_order_relaxed);
+    nodesVisited.store(0, std::memory_order_relaxed);
+    for (auto& bucket : depthHistogram)
+        bucket.store(0, std::memory_order_relaxed);
+    // The node counts are shared, so a reset only moves this tree's baseline
+    constructedAtReset = nodeCounts().constructed.load(std::memory_order_relaxed);
+    destroyedAtReset = nodeCounts().destroyed.load(std::memory_order_relaxed);
+}  // end reset
+
+// Counts one search, or one traversal, in local variables and adds the
+// totals to the tree's counters once, when it goes out of scope.
+class StatsProbe
+{
+private:
+    TreeStatsCounters* countersPtr;
+    bool isSearch;
+    long long probeComparisons;
+    long long probeVisits;
+
+public:
+    StatsProbe(TreeStatsCounters* aCountersPtr, bool search)
+            : countersPtr(aCountersPtr), isSearch(search), probeComparisons(0), probeVisits(0)
+    { }
+
+    StatsProbe(const StatsProbe&) = delete;
+    StatsProbe& operator=(const StatsProbe&) = delete;
+
+    ~StatsProbe()
+    {
+        if (isSearch)
+            countersPtr->addSearch(probeComparisons, probeVisits);
+        else
+            countersPtr->addVisits(probeVisits);
+    }
+
+    void compared(int count = 1) { probeComparisons += count; }
+    void visited(int count = 1) { probeVisits += count; }
+}; // end StatsProbe
+
+#else
+
+class TreeStatsCounters;
+
+// Stands in for the counting probe; every call compiles to nothing.
+class StatsProbe
+{
+public:
+    StatsProbe(TreeStatsCounters*, bool) { }
+
+    StatsProbe(const StatsProbe&) = delete;
+    StatsProbe& operator=(const StatsProbe&) = delete;
+
+    void compared(int = 1) { }
+    void visited(int = 1) { }
+}; // end StatsProbe
+
+#endif //BINARY_TREE_STATS
+
+#endif //TREE_STATS_
@@ -6,7 +6,7 @@
 #include "BinarySearchTree.h"
 
 //Display function for pre/in/post order traversal
-void display(int& anEntry){
+void display(const int& anEntry){
     std::cout << std::setw(3) << anEntry << " ";
 }
 
@@ -0,0 +1,1164 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstddef>
+#include <new>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <sys/resource.h>
+#include "BinarySearchTree.h"
+#include "AVLTree.h"
+#include "ArenaSearchTree.h"
+#include "FrozenSearchTree.h"
+#include "BPlusTree.h"
+#include "PersistentSearchTree.h"
+#include "ConcurrentSearchTree.h"
+#include "CountedSearchTree.h"
+#include "TreeSnapshot.h"
+
+//Benchmark driver for the tree containers. Build with the treebench target
+//of CMakeLists.txt (cmake -S . -B build && cmake --build build), or directly with
+//  g++ -std=c++14 -O2 -pthread -o treebench treebench.cpp
+//Add -DTREE_NATIVE_ARCH=ON to the cmake configure step (or -march=native to g++) to
+//build the AVX2 key search that the wide benchmark reports.
+//Usage: treebench <benchmark> [sizes...]
+//  suite [maxKeys] [items]        BinarySearchTree/AVLTree add, contains, traversal, copy, remove and clear
+//                                 over 1K..maxKeys entries of uniform, sorted, reverse, zipf and duplicate
+//                                 key streams; items is a comma list of int,string,record (64-byte struct).
+//                                 Prints CSV: tree,item,stream,n,operation,ops,seconds,ns_per_op,ops_per_sec,peak_rss_kb
+//  balanced [avlKeys] [bstKeys]   monotonically increasing inserts, AVLTree vs BinarySearchTree
+//  arena [keys]                   shared_ptr nodes vs NodePool slab, with heap allocation counts
+//  skewed [nodes] [copy]          every tree operation on a degenerate (linked-list) tree;
+//                                 copy=0 skips the copy phase, which doubles peak memory
+//  bulk [keys]                    add() per key vs the bulk-loading constructor, sorted and shuffled input
+//  frozen [sizes...]              contains() on AVLTree vs its FrozenSearchTree snapshot, per tree size
+//  wide [keys]                    binary node trees vs the SIMD-searched BPlusTree on random int keys
+//  concurrent [keys] [ops]        mutex-wrapped AVLTree vs ConcurrentSearchTree, 1-64 threads, 0/1/10/50% writes
+//  parallel [nodes] [threads]     sequential inorderTraverse vs parallelForEach/parallelReduce, 1..threads threads
+//  visitor [nodes]                inorderTraverse per-node cost: function pointer vs capturing lambda
+//  cursor [nodes] [k]             first k entries: full inorderTraverse vs an inorderCursor stopped after k
+//  merge [keys] [batch]           folding a batch tree into a large one: add() per entry vs mergeFrom/unionWith
+//  split [keys] [rounds]          cutting a tree at its median and putting it back: add() rebuild vs split/join
+//  snapshot [keys] [versions]     snapshot then add: AVLTree deep copy vs PersistentSearchTree shared version
+//  counted [entries] [distinct]   skewed duplicates: AVLTree node per copy vs CountedSearchTree counts
+//  load [keys] [file]             restart from a snapshot file: add() per entry vs mmap + bulk build vs mmap lookups
+//  batch [sizes...]               random lookups on AVLTree: contains() per key vs containsBatch/findBatch
+//  move [keys]                    48-character string entries: add() copy vs add() move vs emplace, removal,
+//                                 and handing a whole tree on by copy vs by move; with heap allocation counts
+//  compare [keys]                 string lookups: == then > per node vs one three-way compare; record lookups
+//                                 through a built probe record vs a transparent std::string key
+
+using Clock = std::chrono::steady_clock;
+
+//Every heap allocation made by the process goes through here, so benchmarks can
+//report how many allocations (and bytes) a phase cost. The concurrent runs
+//allocate from several threads, so the counters are relaxed atomics.
+//The replacements are kept out of line: once GCC inlines them, it pairs the
+//malloc() and free() inside with the operator new and delete calls around them
+//and reports the pairs as mismatched.
+#if defined(__GNUC__)
+#define OUT_OF_LINE __attribute__((noinline))
+#else
+#define OUT_OF_LINE
+#endif
+
+std::atomic<std::size_t> heapAllocations(0);
+std::atomic<std::size_t> heapBytes(0);
+
+OUT_OF_LINE void* operator new(std::size_t size){
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+OUT_OF_LINE void operator delete(void* memory) noexcept{
+    std::free(memory);
+}
+
+OUT_OF_LINE void operator delete(void* memory, std::size_t) noexcept{
+    std::free(memory);
+}
+
+//Benchmarks that check their results count each mismatch here, and the
+//process exits with status 1 if there was any.
+int resultMismatches = 0;
+
+double secondsSince(Clock::time_point start){
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+long argOrDefault(int argc, char* argv[], int index, long defaultValue){
+    return (argc > index) ? std::atol(argv[index]) : defaultValue;
+}
+
+void report(const std::string& label, long operations, double seconds){
+    std::cout << std::left << std::setw(40) << label
+              << std::right << std::setw(12) << operations << " ops "
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds << " s "
+              << std::setw(12) << std::setprecision(1) << (seconds * 1e9 / operations) << " ns/op\n";
+}
+
+//Inserts keys 0..count-1 in increasing order and reports the resulting height.
+//The unbalanced tree degenerates into a list, so it is run with far fewer keys
+//(every insert walks the whole list, and the recursion depth equals the key count).
+template<class TreeType>
+void sortedInsert(const std::string& label, long count){
+    TreeType tree;
+    auto start = Clock::now();
+    for (long i = 0; i < count; i++) {
+        tree.add(static_cast<int>(i));
+    }
+    double seconds = secondsSince(start);
+    report(label + " add (sorted)", count, seconds);
+    std::cout << "    height " << tree.getHeight() << "\n";
+}
+
+void balancedBenchmark(long avlKeys, long bstKeys){
+    std::cout << "\t\t***Sorted insert: AVLTree vs BinarySearchTree***\n";
+    sortedInsert<AVLTree<int>>("AVLTree<int>", avlKeys);
+    sortedInsert<BinarySearchTree<int>>("BinarySearchTree<int>", bstKeys);
+}
+
+std::vector<int> randomKeys(long count, unsigned seed){
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<int> dist(0, 1 << 30);
+    std::vector<int> keys(count);
+    for (auto& key : keys) {
+        key = dist(generator);
+    }
+    return keys;
+}
+
+//Builds a tree from random keys, probes every key and destroys it, counting heap traffic per phase.
+template<class TreeType>
+void layoutRun(const std::string& label, const std::vector<int>& keys){
+    auto tree = std::make_unique<TreeType>();
+    long count = static_cast<long>(keys.size());
+
+    std::size_t allocationsBefore = heapAllocations, bytesBefore = heapBytes;
+    auto start = Clock::now();
+    for (int key : keys) {
+        tree->add(key);
+    }
+    report(label + " add", count, secondsSince(start));
+    std::cout << "    heap allocations " << (heapAllocations - allocationsBefore)
+              << ", bytes " << (heapBytes - bytesBefore) << "\n";
+
+    long found = 0;
+    start = Clock::now();
+    for (int key : keys) {
+        found += tree->contains(key);
+    }
+    report(label + " contains", count, secondsSince(start));
+
+    start = Clock::now();
+    tree.reset();
+    report(label + " destroy", count, secondsSince(start));
+    if (found != count) {
+        std::cout << "    ERROR: only " << found << " keys found\n";
+        resultMismatches++;
+    }
+}
+
+void arenaBenchmark(long keyCount){
+    std::cout << "\t\t***Node layout: shared_ptr nodes vs NodePool slab***\n";
+    auto keys = randomKeys(keyCount, 42);
+    layoutRun<BinarySearchTree<int>>("BinarySearchTree<int>", keys);
+    layoutRun<ArenaSearchTree<int>>("ArenaSearchTree<int>", keys);
+
+    ArenaSearchTree<int> arenaTree;
+    for (int key : keys) {
+        arenaTree.add(key);
+    }
+    for (long i = 0; i < keyCount; i += 2) {
+        arenaTree.remove(keys[i]);
+    }
+    for (long i = 0; i < keyCount; i += 2) {
+        arenaTree.add(keys[i]);
+    }
+    NodePoolStats stats = arenaTree.getPoolStats();
+    std::cout << "    pool after add/remove-half/re-add: allocations " << stats.allocations
+              << ", frees " << stats.frees << ", live " << stats.liveNodes
+              << ", peak " << stats.peakNodes << ", slab growths " << stats.slabGrowths
+              << ", capacity " << stats.capacity << "\n";
+}
+
+//Exposes the root so that a degenerate tree can be linked up directly in O(n);
+//building it through add() would cost O(n^2) comparisons.
+class SkewedTree : public BinarySearchTree<int>
+{
+public:
+    explicit SkewedTree(long count){
+        for (long i = count - 1; i >= 0; i--) {
+            this->rootPtr = std::make_shared<BinaryNode<int>>(static_cast<int>(i), nullptr, std::move(this->rootPtr));
+        }
+    }
+};
+
+long long visitSum = 0;
+
+void sumVisit(const int& anEntry){
+    visitSum += anEntry;
+}
+
+//Runs each tree algorithm once over a right-leaning chain of nodeCount nodes.
+//Any recursion proportional to the depth of the tree would overflow the stack here.
+void skewedBenchmark(long nodeCount, bool withCopy){
+    std::cout << "\t\t***Degenerate tree stress: " << nodeCount << " nodes***\n";
+    auto start = Clock::now();
+    auto tree = std::make_unique<SkewedTree>(nodeCount);
+    report("build chain", nodeCount, secondsSince(start));
+
+    start = Clock::now();
+    int height = tree->getHeight();
+    report("getHeight", nodeCount, secondsSince(start));
+    start = Clock::now();
+    int numberOfNodes = tree->getNumberOfNodes();
+    report("getNumberOfNodes", nodeCount, secondsSince(start));
+    std::cout << "    height " << height << ", nodes " << numberOfNodes << "\n";
+
+    start = Clock::now();
+    tree->preorderTraverse(sumVisit);
+    report("preorderTraverse", nodeCount, secondsSince(start));
+    start = Clock::now();
+    tree->inorderTraverse(sumVisit);
+    report("inorderTraverse", nodeCount, secondsSince(start));
+    start = Clock::now();
+    tree->postorderTraverse(sumVisit);
+    report("postorderTraverse", nodeCount, secondsSince(start));
+
+    int lastKey = static_cast<int>(nodeCount - 1);
+    start = Clock::now();
+    bool found = tree->contains(lastKey);
+    report("contains (deepest key)", nodeCount, secondsSince(start));
+    start = Clock::now();
+    tree->add(lastKey + 1);
+    report("add (below deepest key)", nodeCount, secondsSince(start));
+    start = Clock::now();
+    bool removed = tree->remove(lastKey + 1) && tree->remove(0);
+    report("remove (deepest key, then root)", nodeCount, secondsSince(start));
+    if (!found || !removed) {
+        std::cout << "    ERROR: lookup or removal failed\n";
+        resultMismatches++;
+    }
+
+    if (withCopy) {
+        start = Clock::now();
+        auto copy = std::make_unique<BinarySearchTree<int>>(*tree);
+        report("copy constructor", nodeCount, secondsSince(start));
+        start = Clock::now();
+        copy.reset();
+        report("destroy copy", nodeCount, secondsSince(start));
+    }
+
+    start = Clock::now();
+    tree.reset();
+    report("destroy", nodeCount, secondsSince(start));
+    std::cout << "    visitor checksum " << visitSum << "\n";
+}
+
+//Loads the same keys once through add() and once through the bulk-loading constructor.
+void bulkRun(const std::string& label, const std::vector<int>& keys){
+    long count = static_cast<long>(keys.size());
+    auto start = Clock::now();
+    {
+        AVLTree<int> tree;
+        for (int key : keys) {
+            tree.add(key);
+        }
+        report("AVLTree<int> add " + label, count, secondsSince(start));
+        std::cout << "    height " << tree.getHeight() << "\n";
+    }
+    start = Clock::now();
+    {
+        AVLTree<int> tree(keys.begin(), keys.end());
+        report("AVLTree<int> bulk load " + label, count, secondsSince(start));
+        std::cout << "    height " << tree.getHeight() << "\n";
+    }
+}
+
+void bulkBenchmark(long keyCount){
+    std::cout << "\t\t***Bulk load vs add() per key***\n";
+    std::vector<int> keys(keyCount);
+    for (long i = 0; i < keyCount; i++) {
+        keys[i] = static_cast<int>(i);
+    }
+    bulkRun("(sorted)", keys);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    bulkRun("(shuffled)", keys);
+}
+
+//Probes a tree with random keys, half of which are absent, and reports lookups per second.
+template<class TreeType>
+void lookupRun(const std::string& label, const TreeType& tree, const std::vector<int>& probes){
+    long count = static_cast<long>(probes.size());
+    long found = 0;
+    auto start = Clock::now();
+    for (int probe : probes) {
+        found += tree.contains(probe);
+    }
+    double seconds = secondsSince(start);
+    report(label, count, seconds);
+    std::cout << "    " << std::setprecision(1) << (count / seconds / 1e6) << " M lookups/s, "
+              << found << " hits\n";
+}
+
+//A shared_ptr node costs about 64 bytes, so pointer trees larger than this are
+//left out rather than exhausting memory; the snapshot needs sizeof(int) per key.
+const long POINTER_TREE_LIMIT = 20000000;
+
+void frozenBenchmark(const std::vector<long>& sizes){
+    std::cout << "\t\t***Lookups: AVLTree vs FrozenSearchTree (Eytzinger layout)***\n";
+    for (long keyCount : sizes) {
+        //Even keys are stored, so probes drawn from [0, 2n) miss half the time
+        std::vector<int> keys(keyCount);
+        for (long i = 0; i < keyCount; i++) {
+            keys[i] = static_cast<int>(2 * i);
+        }
+        std::vector<int> probes = randomKeys(std::min(keyCount, 10000000L), 7);
+        for (int& probe : probes) {
+            probe %= static_cast<int>(2 * keyCount);
+        }
+
+        std::cout << "  " << keyCount << " keys\n";
+        if (keyCount <= POINTER_TREE_LIMIT) {
+            AVLTree<int> tree(keys.begin(), keys.end());
+            lookupRun("AVLTree<int> contains", tree, probes);
+            auto start = Clock::now();
+            FrozenSearchTree<int> snapshot = tree.freeze();
+            report("freeze", keyCount, secondsSince(start));
+            lookupRun("FrozenSearchTree<int> contains", snapshot, probes);
+        }
+        else {
+            FrozenSearchTree<int> snapshot(keys.begin(), keys.end());
+            lookupRun("FrozenSearchTree<int> contains", snapshot, probes);
+        }
+    }
+}
+
+void wideBenchmark(long keyCount){
+    std::cout << "\t\t***Node width: binary nodes vs " << WIDE_NODE_CAPACITY << "-key B+ tree nodes ("
+              << keySearchKernel() << " search)***\n";
+    auto keys = randomKeys(keyCount, 42);
+    layoutRun<AVLTree<int>>("AVLTree<int>", keys);
+    layoutRun<ArenaSearchTree<int>>("ArenaSearchTree<int>", keys);
+    layoutRun<BPlusTree<int>>("BPlusTree<int>", keys);
+}
+
+//The usual way to share a tree today: one global lock around every call.
+class LockedTree
+{
+private:
+    AVLTree<int> tree;
+    std::mutex treeMutex;
+public:
+    template<class InputIterator>
+    LockedTree(InputIterator first, InputIterator last) : tree(first, last) { }
+    bool contains(int key){
+        std::lock_guard<std::mutex> lock(treeMutex);
+        return tree.contains(key);
+    }
+    bool add(int key){
+        std::lock_guard<std::mutex> lock(treeMutex);
+        return tree.add(key);
+    }
+    bool remove(int key){
+        std::lock_guard<std::mutex> lock(treeMutex);
+        return tree.remove(key);
+    }
+};
+
+//Splits ops operations over threadCount threads. writePercent of them alternately
+//add and remove a random key, so the tree keeps its size; the rest call contains().
+template<class TreeType>
+void concurrentRun(const std::string& label, TreeType& tree, long keyCount, long ops,
+                   int threadCount, int writePercent){
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (int thread = 0; thread < threadCount; thread++) {
+        threads.emplace_back([&tree, keyCount, ops, threadCount, writePercent, thread]{
+            std::mt19937_64 generator(thread);
+            std::uniform_int_distribution<int> keyDist(0, static_cast<int>(2 * keyCount));
+            std::uniform_int_distribution<int> percentDist(0, 99);
+            bool addNext = true;
+            for (long op = thread; op < ops; op += threadCount) {
+                int key = keyDist(generator);
+                if (percentDist(generator) < writePercent) {
+                    if (addNext)
+                        tree.add(key);
+                    else
+                        tree.remove(key);
+                    addNext = !addNext;
+                }
+                else {
+                    tree.contains(key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = secondsSince(start);
+    report(label + " " + std::to_string(threadCount) + "T " + std::to_string(writePercent) + "%w", ops, seconds);
+}
+
+void concurrentBenchmark(long keyCount, long ops){
+    std::cout << "\t\t***Shared tree: global mutex vs ConcurrentSearchTree ("
+              << std::thread::hardware_concurrency() << " hardware threads)***\n";
+    std::vector<int> keys(keyCount);
+    for (long i = 0; i < keyCount; i++) {
+        keys[i] = static_cast<int>(2 * i);
+    }
+    LockedTree lockedTree(keys.begin(), keys.end());
+    ConcurrentSearchTree<int> sharedTree(keys.begin(), keys.end());
+    for (int writePercent : {0, 1, 10, 50}) {
+        for (int threadCount = 1; threadCount <= 64; threadCount *= 2) {
+            concurrentRun("mutex AVLTree", lockedTree, keyCount, ops, threadCount, writePercent);
+            concurrentRun("ConcurrentSearchTree", sharedTree, keyCount, ops, threadCount, writePercent);
+        }
+    }
+}
+
+//Stands in for per-node work that costs more than the walk itself.
+long long hashEntry(int anEntry){
+    unsigned long long hash = static_cast<unsigned long long>(anEntry);
+    for (int round = 0; round < 64; round++) {
+        hash = (hash ^ (hash >> 31)) * 0x9E3779B97F4A7C15ULL;
+    }
+    return static_cast<long long>(hash >> 1);
+}
+
+void hashVisit(const int& anEntry){
+    visitSum += hashEntry(anEntry);
+}
+
+void parallelBenchmark(long nodeCount, int maxThreads){
+    std::cout << "\t\t***Parallel traversal: " << nodeCount << " nodes ("
+              << std::thread::hardware_concurrency() << " hardware threads)***\n";
+    std::vector<int> keys(nodeCount);
+    for (long i = 0; i < nodeCount; i++) {
+        keys[i] = static_cast<int>(i);
+    }
+    AVLTree<int> tree(keys.begin(), keys.end());
+
+    visitSum = 0;
+    auto start = Clock::now();
+    tree.inorderTraverse(hashVisit);
+    report("inorderTraverse", nodeCount, secondsSince(start));
+    long long expected = visitSum;
+
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        std::atomic<long long> forEachSum(0);
+        start = Clock::now();
+        tree.parallelForEach([&forEachSum](const int& anEntry) {
+            forEachSum.fetch_add(hashEntry(anEntry), std::memory_order_relaxed);
+        }, threadCount);
+        report("parallelForEach " + std::to_string(threadCount) + "T", nodeCount, secondsSince(start));
+
+        start = Clock::now();
+        long long reduceSum = tree.parallelReduce(0LL,
+            [](long long sum, const int& anEntry) { return sum + hashEntry(anEntry); },
+            [](long long leftSum, long long rightSum) { return leftSum + rightSum; }, threadCount);
+        report("parallelReduce " + std::to_string(threadCount) + "T", nodeCount, secondsSince(start));
+
+        if ((forEachSum.load() != expected) || (reduceSum != expected)) {
+            std::cout << "  result mismatch\n";
+            resultMismatches++;
+        }
+    }
+}
+
+void sumCopyVisit(int& anEntry){
+    visitSum += anEntry;
+}
+
+//Sums every key through each kind of traversal entry point.
+void visitorBenchmark(long nodeCount){
+    std::cout << "\t\t***Traversal visitors: " << nodeCount << " nodes***\n";
+    std::vector<int> keys(nodeCount);
+    for (long i = 0; i < nodeCount; i++) {
+        keys[i] = static_cast<int>(i);
+    }
+    AVLTree<int> tree(keys.begin(), keys.end());
+    BinaryTreeInterface<int>* treePtr = &tree;
+    long long expected = static_cast<long long>(nodeCount) * (nodeCount - 1) / 2;
+
+    visitSum = 0;
+    auto start = Clock::now();
+    treePtr->inorderTraverse(sumCopyVisit);
+    report("interface, function pointer", nodeCount, secondsSince(start));
+    long long interfaceSum = visitSum;
+
+    visitSum = 0;
+    start = Clock::now();
+    tree.inorderTraverse(sumVisit);
+    report("template, function pointer", nodeCount, secondsSince(start));
+    long long pointerSum = visitSum;
+
+    long long lambdaSum = 0;
+    start = Clock::now();
+    tree.inorderTraverse([&lambdaSum](const int& anEntry) { lambdaSum += anEntry; });
+    report("template, capturing lambda", nodeCount, secondsSince(start));
+
+    if ((interfaceSum != expected) || (pointerSum != expected) || (lambdaSum != expected)) {
+        std::cout << "  result mismatch\n";
+        resultMismatches++;
+    }
+}
+
+void cursorBenchmark(long nodeCount, long firstCount){
+    std::cout << "\t\t***Lazy traversal: first " << firstCount << " of " << nodeCount << " nodes***\n";
+    std::vector<int> keys(nodeCount);
+    for (long i = 0; i < nodeCount; i++) {
+        keys[i] = static_cast<int>(i);
+    }
+    AVLTree<int> tree(keys.begin(), keys.end());
+
+    //A callback traversal cannot stop early, so it walks every node
+    long long traverseSum = 0;
+    long seen = 0;
+    auto start = Clock::now();
+    tree.inorderTraverse([&traverseSum, &seen, firstCount](const int& anEntry) {
+        if (seen++ < firstCount) {
+            traverseSum += anEntry;
+        }
+    });
+    report("inorderTraverse", firstCount, secondsSince(start));
+
+    long long cursorSum = 0;
+    start = Clock::now();
+    TraversalCursor<int> cursor = tree.inorderCursor();
+    for (long i = 0; (i < firstCount) && cursor.hasNext(); i++) {
+        cursorSum += cursor.next();
+    }
+    report("inorderCursor", firstCount, secondsSince(start));
+
+    if (traverseSum != cursorSum) {
+        std::cout << "  result mismatch\n";
+        resultMismatches++;
+    }
+}
+
+void mergeBenchmark(long keyCount, long batchCount){
+    std::cout << "\t\t***Merging a batch of " << batchCount << " into " << keyCount << " keys***\n";
+    std::vector<int> keys = randomKeys(keyCount, 1);
+    std::vector<int> batch = randomKeys(batchCount, 2);
+
+    AVLTree<int> addTree(keys.begin(), keys.end());
+    AVLTree<int> addBatch(batch.begin(), batch.end());
+    auto start = Clock::now();
+    addBatch.inorderTraverse([&addTree](const int& anEntry) { addTree.add(anEntry); });
+    report("add() per batch entry", batchCount, secondsSince(start));
+
+    AVLTree<int> mergeTree(keys.begin(), keys.end());
+    AVLTree<int> mergeBatch(batch.begin(), batch.end());
+    start = Clock::now();
+    mergeTree.mergeFrom(mergeBatch);
+    report("mergeFrom", batchCount, secondsSince(start));
+
+    AVLTree<int> unionTree(keys.begin(), keys.end());
+    AVLTree<int> unionBatch(batch.begin(), batch.end());
+    start = Clock::now();
+    unionTree.unionWith(unionBatch);
+    report("unionWith", batchCount, secondsSince(start));
+
+    if (mergeTree.getNumberOfNodes() != addTree.getNumberOfNodes()) {
+        std::cout << "  result mismatch\n";
+        resultMismatches++;
+    }
+}
+
+void splitBenchmark(long keyCount, long rounds){
+    std::cout << "\t\t***Split and join at the median of " << keyCount << " keys***\n";
+    std::vector<int> keys(keyCount);
+    for (long i = 0; i < keyCount; i++) {
+        keys[i] = static_cast<int>(i);
+    }
+    int median = static_cast<int>(keyCount / 2);
+
+    //Without split, the upper half is copied out with add() and removed one entry at a time
+    AVLTree<int> copyTree(keys.begin(), keys.end());
+    AVLTree<int> copyUpper;
+    auto start = Clock::now();
+    for (long i = median; i < keyCount; i++) {
+        copyUpper.add(keys[i]);
+        copyTree.remove(keys[i]);
+    }
+    report("add/remove per moved entry", 1, secondsSince(start));
+
+    AVLTree<int> tree(keys.begin(), keys.end());
+    AVLTree<int> upper;
+    start = Clock::now();
+    for (long round = 0; round < rounds; round++) {
+        tree.split(median, upper);
+        tree.join(upper);
+    }
+    report("split + join", rounds, secondsSince(start));
+
+    if (tree.getNumberOfNodes() != keyCount) {
+        std::cout << "  result mismatch\n";
+        resultMismatches++;
+    }
+}
+
+//Takes a snapshot before each add, as a reader that needs a consistent view would.
+void snapshotBenchmark(long keyCount, long versionCount){
+    std::cout << "\t\t***Snapshots of " << keyCount << " keys***\n";
+    std::vector<int> keys(keyCount);
+    for (long i = 0; i < keyCount; i++) {
+        keys[i] = static_cast<int>(2 * i);
+    }
+    std::vector<int> newKeys = randomKeys(versionCount, 5);
+    for (auto& key : newKeys) {
+        key |= 1;
+    }
+
+    AVLTree<int> copiedTree(keys.begin(), keys.end());
+    long copyCount = std::min(versionCount, 20L);
+    auto start = Clock::now();
+    for (long i = 0; i < copyCount; i++) {
+        AVLTree<int> snapshot(copiedTree);
+        copiedTree.add(newKeys[i]);
+    }
+    report("AVLTree copy + add", copyCount, secondsSince(start));
+
+    PersistentSearchTree<int> version(keys.begin(), keys.end());
+    std::vector<PersistentSearchTree<int>> history;
+    history.reserve(versionCount);
+    start = Clock::now();
+    for (long i = 0; i < versionCount; i++) {
+        history.push_back(version);
+        version = version.added(newKeys[i]);
+    }
+    report("PersistentSearchTree added()", versionCount, secondsSince(start));
+
+    if ((version.getNumberOfNodes() != keyCount + versionCount) || (history.front().getNumberOfNodes() != keyCount)) {
+        std::cout << "  result mismatch\n";
+        resultMismatches++;
+    }
+}
+
+template<class TreeType>
+void countedRun(const std::string& label, const std::vector<int>& entries){
+    TreeType tree;
+    auto start = Clock::now();
+    for (int anEntry : entries) {
+        tree.add(anEntry);
+    }
+    report(label + " add", static_cast<long>(entries.size()), secondsSince(start));
+    long found = 0;
+    start = Clock::now();
+    for (int anEntry : entries) {
+        found += tree.contains(anEntry + 1) ? 1 : 0;
+    }
+    report(label + " contains", static_cast<long>(entries.size()), secondsSince(start));
+    std::cout << "  nodes " << tree.getNumberOfNodes() << ", height " << tree.getHeight()
+              << ", found " << found << "\n";
+}
+
+//Keys follow a geometric distribution, so the smallest few repeat very often.
+void countedBenchmark(long entryCount, long distinctCount){
+    std::cout << "\t\t***" << entryCount << " entries over " << distinctCount << " distinct keys***\n";
+    std::mt19937_64 generator(9);
+    std::geometric_distribution<int> spread(4.0 / distinctCount);
+    std::vector<int> entries(entryCount);
+    for (auto& anEntry : entries) {
+        anEntry = 2 * (spread(generator) % static_cast<int>(distinctCount));
+    }
+    countedRun<AVLTree<int>>("AVLTree", entries);
+    countedRun<CountedSearchTree<int>>("CountedSearchTree", entries);
+}
+
+void loadBenchmark(long keyCount, const std::string& fileName){
+    std::cout << "\t\t***Snapshot of " << keyCount << " keys in " << fileName << "***\n";
+    std::vector<int> keys = randomKeys(keyCount, 11);
+    AVLTree<int> tree(keys.begin(), keys.end());
+    auto start = Clock::now();
+    writeSnapshot(tree, fileName);
+    report("writeSnapshot", keyCount, secondsSince(start));
+
+    start = Clock::now();
+    {
+        MappedSnapshot<int> snapshot(fileName);
+        AVLTree<int> rebuilt;
+        for (int anEntry : snapshot) {
+            rebuilt.add(anEntry);
+        }
+    }
+    report("map + add() per entry", keyCount, secondsSince(start));
+
+    start = Clock::now();
+    {
+        MappedSnapshot<int> snapshot(fileName);
+        AVLTree<int> rebuilt(snapshot.begin(), snapshot.end());
+    }
+    report("map + checksum + bulk build", keyCount, secondsSince(start));
+
+    //Served straight from the mapping: only the pages the lookups touch are read
+    std::vector<int> probes = randomKeys(1000000, 12);
+    start = Clock::now();
+    long found = 0;
+    {
+        MappedSnapshot<int> snapshot(fileName, false);
+        for (int probe : probes) {
+            found += snapshot.contains(probe) ? 1 : 0;
+        }
+    }
+    report("map + 1M contains()", static_cast<long>(probes.size()), secondsSince(start));
+    std::cout << "  found " << found << "\n";
+    std::remove(fileName.c_str());
+}
+
+void batchBenchmark(const std::vector<long>& sizes){
+    std::cout << "\t\t***Lookups: contains() loop vs interleaved containsBatch/findBatch***\n";
+    for (long keyCount : sizes) {
+        //Random keys, so consecutive probes share no path; probes miss about half the time
+        std::vector<int> keys = randomKeys(keyCount, 23);
+        AVLTree<int> tree;
+        for (int key : keys) {
+            tree.add(key);
+        }
+        std::vector<int> probes = randomKeys(std::min(keyCount, 2000000L), 24);
+        for (std::size_t i = 0; i < probes.size(); i += 2) {
+            probes[i] = keys[i % keys.size()];
+        }
+        long count = static_cast<long>(probes.size());
+
+        std::cout << "  " << keyCount << " keys, " << count << " probes\n";
+        lookupRun("contains() per key", tree, probes);
+
+        std::vector<char> found(probes.size());
+        auto start = Clock::now();
+        tree.containsBatch(probes.begin(), probes.end(), found.begin());
+        double seconds = secondsSince(start);
+        report("containsBatch", count, seconds);
+        std::cout << "    " << std::setprecision(1) << (count / seconds / 1e6) << " M lookups/s, "
+                  << std::count(found.begin(), found.end(), 1) << " hits\n";
+
+        std::vector<const int*> entries(probes.size());
+        start = Clock::now();
+        tree.findBatch(probes.begin(), probes.end(), entries.begin());
+        seconds = secondsSince(start);
+        report("findBatch", count, seconds);
+        std::cout << "    " << std::setprecision(1) << (count / seconds / 1e6) << " M lookups/s, "
+                  << (count - std::count(entries.begin(), entries.end(), nullptr)) << " hits\n";
+    }
+}
+
+//A 64-byte entry ordered by its key, standing in for records carried in a tree.
+struct Record64 {
+    std::int64_t key;
+    char payload[56];
+
+    bool operator>(const Record64& rightHandSide) const { return key > rightHandSide.key; }
+    bool operator==(const Record64& rightHandSide) const { return key == rightHandSide.key; }
+};
+
+template<class ItemType>
+ItemType makeItem(std::uint32_t key);
+
+template<>
+int makeItem<int>(std::uint32_t key){
+    return static_cast<int>(key);
+}
+
+//Long enough to defeat the small-string optimization, with the key at the end,
+//so comparisons read past a shared prefix as real identifiers do.
+template<>
+std::string makeItem<std::string>(std::uint32_t key){
+    std::string digits = std::to_string(key);
+    return "customer-account-" + std::string(10 - digits.size(), '0') + digits;
+}
+
+template<>
+Record64 makeItem<Record64>(std::uint32_t key){
+    Record64 record;
+    record.key = key;
+    std::memset(record.payload, static_cast<int>(key & 0x7F), sizeof(record.payload));
+    return record;
+}
+
+//Keys in [0, 2^31) drawn the way the named stream draws them.
+std::vector<std::uint32_t> keyStream(const std::string& stream, long count, unsigned seed){
+    std::mt19937_64 generator(seed);
+    std::vector<std::uint32_t> keys(count);
+    //Spreads small ranks over the key space, so popular keys are not also adjacent
+    auto scatter = [](std::uint64_t rank) { return static_cast<std::uint32_t>((rank * 2654435761ULL) & 0x7FFFFFFF); };
+    if (stream == "sorted" || stream == "reverse") {
+        for (long i = 0; i < count; i++) {
+            keys[i] = static_cast<std::uint32_t>(stream == "sorted" ? i : count - 1 - i);
+        }
+    }
+    else if (stream == "zipf") {
+        //Zipf(0.99) over up to 2^20 ranks, drawn by inverting the cumulative weights
+        std::size_t ranks = static_cast<std::size_t>(std::min(count, 1L << 20));
+        std::vector<double> cumulative(ranks);
+        double total = 0;
+        for (std::size_t rank = 0; rank < ranks; rank++) {
+            total += 1.0 / std::pow(static_cast<double>(rank + 1), 0.99);
+            cumulative[rank] = total;
+        }
+        std::uniform_real_distribution<double> dist(0, total);
+        for (auto& key : keys) {
+            std::size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), dist(generator)) - cumulative.begin();
+            key = scatter(std::min(rank, ranks - 1));
+        }
+    }
+    else if (stream == "duplicate") {
+        //Every key repeats about a thousand times
+        std::uniform_int_distribution<std::uint64_t> dist(0, std::max(1L, count / 1000) - 1);
+        for (auto& key : keys) {
+            key = scatter(dist(generator));
+        }
+    }
+    else {
+        std::uniform_int_distribution<std::uint32_t> dist(0, 0x7FFFFFFF);
+        for (auto& key : keys) {
+            key = dist(generator);
+        }
+    }
+    return keys;
+}
+
+//Peak resident set size of the process so far, in KB.
+long peakRssKb(){
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+void csvRow(const std::string& prefix, const std::string& operation, long operations, double seconds){
+    std::cout << prefix << operation << "," << operations << "," << std::setprecision(6) << seconds << ","
+              << std::setprecision(1) << (seconds * 1e9 / operations) << ","
+              << std::setprecision(0) << (operations / seconds) << "," << peakRssKb() << "\n";
+}
+
+template<class TreeType, class ItemType>
+void suiteRun(const std::string& prefix, const std::vector<ItemType>& items){
+    long count = static_cast<long>(items.size());
+    TreeType tree;
+    auto start = Clock::now();
+    for (const auto& anItem : items) {
+        tree.add(anItem);
+    }
+    csvRow(prefix, "add", count, secondsSince(start));
+
+    long found = 0;
+    start = Clock::now();
+    for (const auto& anItem : items) {
+        found += tree.contains(anItem) ? 1 : 0;
+    }
+    csvRow(prefix, "contains", count, secondsSince(start));
+
+    long visited = 0;
+    start = Clock::now();
+    tree.inorderTraverse([&visited](const ItemType&) { visited++; });
+    csvRow(prefix, "inorderTraverse", count, secondsSince(start));
+
+    start = Clock::now();
+    {
+        TreeType copy(tree);
+        visited += copy.getNumberOfNodes();
+    }
+    csvRow(prefix, "copy", count, secondsSince(start));
+
+    //Removes the first half of the stream, one entry per call
+    long removeCount = count / 2;
+    start = Clock::now();
+    for (long i = 0; i < removeCount; i++) {
+        tree.remove(items[i]);
+    }
+    if (removeCount > 0) {
+        csvRow(prefix, "remove", removeCount, secondsSince(start));
+    }
+
+    long remaining = tree.getNumberOfNodes();
+    start = Clock::now();
+    tree.clear();
+    csvRow(prefix, "clear", std::max(1L, remaining), secondsSince(start));
+    if ((found != count) || (visited != 2 * count)) {
+        std::cerr << prefix << " result mismatch\n";
+        resultMismatches++;
+    }
+}
+
+template<class ItemType>
+void suiteItems(const std::string& itemName, long maxKeys){
+    for (const std::string stream : {"uniform", "sorted", "reverse", "zipf", "duplicate"}) {
+        for (long count = 1000; count <= maxKeys; count *= 10) {
+            std::vector<std::uint32_t> keys = keyStream(stream, count, 21);
+            std::vector<ItemType> items;
+            items.reserve(count);
+            for (std::uint32_t key : keys) {
+                items.push_back(makeItem<ItemType>(key));
+            }
+            std::string prefix = "," + itemName + "," + stream + "," + std::to_string(count) + ",";
+            suiteRun<AVLTree<ItemType>>("AVLTree" + prefix, items);
+            //Without balancing, sorted input builds a list; past 20K entries that is quadratic
+            if ((stream != "sorted" && stream != "reverse") || (count <= 20000)) {
+                suiteRun<BinarySearchTree<ItemType>>("BinarySearchTree" + prefix, items);
+            }
+        }
+    }
+}
+
+void suiteBenchmark(long maxKeys, const std::string& itemTypes){
+    std::cout << std::fixed << "tree,item,stream,n,operation,ops,seconds,ns_per_op,ops_per_sec,peak_rss_kb\n";
+    std::stringstream typeList(itemTypes);
+    std::string itemName;
+    while (std::getline(typeList, itemName, ',')) {
+        if (itemName == "int") {
+            suiteItems<int>(itemName, maxKeys);
+        }
+        else if (itemName == "string") {
+            suiteItems<std::string>(itemName, maxKeys);
+        }
+        else if (itemName == "record") {
+            suiteItems<Record64>(itemName, maxKeys);
+        }
+        else {
+            std::cerr << "Unknown item type: " << itemName << "\n";
+        }
+    }
+}
+
+//Times one phase and reports the heap allocations it made alongside.
+template<class Phase>
+void allocationRun(const std::string& label, long operations, Phase phase){
+    std::size_t allocationsBefore = heapAllocations;
+    auto start = Clock::now();
+    phase();
+    double seconds = secondsSince(start);
+    report(label, operations, seconds);
+    std::cout << "    " << (heapAllocations - allocationsBefore) << " heap allocations\n";
+}
+
+void moveBenchmark(long keyCount){
+    std::cout << "\t\t***Heap-owning entries: copying vs moving into and out of AVLTree<std::string>***\n";
+    //Long enough that every string owns a heap buffer
+    std::vector<std::string> entries;
+    entries.reserve(keyCount);
+    for (int key : randomKeys(keyCount, 24)) {
+        entries.push_back(makeItem<std::string>(static_cast<std::uint32_t>(key)) + std::string(21, '.'));
+    }
+
+    AVLTree<std::string> copiedTree;
+    allocationRun("add(const ItemType&)", keyCount, [&]() {
+        for (const std::string& anEntry : entries) {
+            copiedTree.add(anEntry);
+        }
+    });
+
+    std::vector<std::string> movedEntries(entries);
+    AVLTree<std::string> movedTree;
+    allocationRun("add(ItemType&&)", keyCount, [&]() {
+        for (std::string& anEntry : movedEntries) {
+            movedTree.add(std::move(anEntry));
+        }
+    });
+
+    AVLTree<std::string> emplacedTree;
+    allocationRun("emplace(chars, length)", keyCount, [&]() {
+        for (const std::string& anEntry : entries) {
+            emplacedTree.emplace(anEntry.data(), anEntry.size());
+        }
+    });
+
+    //Removing a node with two children moves its inorder successor into it
+    allocationRun("remove half", keyCount / 2, [&]() {
+        for (long i = 0; i < keyCount; i += 2) {
+            emplacedTree.remove(entries[i]);
+        }
+    });
+
+    //The receivers outlive the timed phases, so only the hand-over is measured
+    AVLTree<std::string> copyReceiver;
+    AVLTree<std::string> moveReceiver;
+    allocationRun("pass tree on: copy", keyCount, [&]() {
+        copyReceiver = copiedTree;
+    });
+    allocationRun("pass tree on: move", keyCount, [&]() {
+        moveReceiver = std::move(copiedTree);
+    });
+}
+
+//The ordering the trees used before comparators: == and then > at every node.
+struct EqualThenGreater {
+    bool operator()(const std::string& leftItem, const std::string& rightItem) const { return rightItem > leftItem; }
+    int compare(const std::string& leftItem, const std::string& rightItem) const {
+        return (leftItem == rightItem) ? 0 : ((leftItem > rightItem) ? 1 : -1);
+    }
+};
+
+//A record that owns heap memory besides its key, so building one just to probe costs allocations.
+struct Account {
+    std::string name;
+    std::vector<double> history;
+
+    //The inherited unordered searches of BinaryNodeTree match entries with ==
+    bool operator==(const Account& rightHandSide) const { return name == rightHandSide.name; }
+};
+
+//Orders accounts by name, and compares an account with a bare name as well.
+struct AccountOrder {
+    typedef void is_transparent;
+    bool operator()(const Account& leftItem, const Account& rightItem) const { return leftItem.name < rightItem.name; }
+    int compare(const Account& leftItem, const Account& rightItem) const { return leftItem.name.compare(rightItem.name); }
+    int compare(const std::string& name, const Account& rightItem) const { return name.compare(rightItem.name); }
+    int compare(const Account& leftItem, const std::string& name) const { return leftItem.name.compare(name); }
+};
+
+template<class TreeType>
+void stringLookupRun(const std::string& label, const TreeType& tree, const std::vector<std::string>& probes){
+    long found = 0;
+    auto start = Clock::now();
+    for (const std::string& probe : probes) {
+        found += tree.contains(probe) ? 1 : 0;
+    }
+    report(label, static_cast<long>(probes.size()), secondsSince(start));
+    std::cout << "    " << found << " hits\n";
+}
+
+void compareBenchmark(long keyCount){
+    std::cout << "\t\t***Comparisons: two operators vs one three-way compare, and transparent keys***\n";
+    //The names share a long prefix, so every comparison reads past it
+    std::vector<std::string> names, probes;
+    for (int key : randomKeys(keyCount, 25)) {
+        names.push_back(makeItem<std::string>(static_cast<std::uint32_t>(key)));
+    }
+    for (int key : randomKeys(keyCount, 26)) {
+        probes.push_back(makeItem<std::string>(static_cast<std::uint32_t>(key)));
+    }
+    for (long i = 0; i < keyCount; i += 2) {
+        probes[i] = names[i];
+    }
+    //Both trees are built side by side, so neither gets the better memory layout
+    AVLTree<std::string, EqualThenGreater> twoOperatorTree;
+    AVLTree<std::string> threeWayTree;
+    for (const std::string& name : names) {
+        twoOperatorTree.add(name);
+        threeWayTree.add(name);
+    }
+    stringLookupRun("contains, == then >", twoOperatorTree, probes);
+    stringLookupRun("contains, std::string::compare", threeWayTree, probes);
+
+    AVLTree<Account, AccountOrder> accounts;
+    for (const std::string& name : names) {
+        accounts.add(Account{name, std::vector<double>(32, 1.0)});
+    }
+    long found = 0;
+    allocationRun("probe record built per lookup", keyCount, [&]() {
+        for (const std::string& probe : probes) {
+            found += accounts.contains(Account{probe, std::vector<double>(32)}) ? 1 : 0;
+        }
+    });
+    allocationRun("transparent std::string key", keyCount, [&]() {
+        for (const std::string& probe : probes) {
+            found += accounts.contains(probe) ? 1 : 0;
+        }
+    });
+    std::cout << "    " << found / 2 << " hits\n";
+}
+
+int main(int argc, char* argv[])
+{
+    std::string benchmark = (argc > 1) ? argv[1] : "balanced";
+
+    if (benchmark == "balanced") {
+        balancedBenchmark(argOrDefault(argc, argv, 2, 10000000), argOrDefault(argc, argv, 3, 20000));
+    }
+    else if (benchmark == "arena") {
+        arenaBenchmark(argOrDefault(argc, argv, 2, 1000000));
+    }
+    else if (benchmark == "skewed") {
+        skewedBenchmark(argOrDefault(argc, argv, 2, 50000000), argOrDefault(argc, argv, 3, 1) != 0);
+    }
+    else if (benchmark == "bulk") {
+        bulkBenchmark(argOrDefault(argc, argv, 2, 10000000));
+    }
+    else if (benchmark == "frozen") {
+        std::vector<long> sizes;
+        for (int i = 2; i < argc; i++) {
+            sizes.push_back(std::atol(argv[i]));
+        }
+        if (sizes.empty()) {
+            sizes = {1000000, 10000000, 100000000};
+        }
+        frozenBenchmark(sizes);
+    }
+    else if (benchmark == "wide") {
+        wideBenchmark(argOrDefault(argc, argv, 2, 1000000));
+    }
+    else if (benchmark == "concurrent") {
+        concurrentBenchmark(argOrDefault(argc, argv, 2, 1000000), argOrDefault(argc, argv, 3, 1000000));
+    }
+    else if (benchmark == "parallel") {
+        long defaultThreads = std::max(1u, std::thread::hardware_concurrency());
+        parallelBenchmark(argOrDefault(argc, argv, 2, 10000000),
+                          static_cast<int>(argOrDefault(argc, argv, 3, defaultThreads)));
+    }
+    else if (benchmark == "visitor") {
+        visitorBenchmark(argOrDefault(argc, argv, 2, 10000000));
+    }
+    else if (benchmark == "cursor") {
+        cursorBenchmark(argOrDefault(argc, argv, 2, 10000000), argOrDefault(argc, argv, 3, 1000));
+    }
+    else if (benchmark == "merge") {
+        mergeBenchmark(argOrDefault(argc, argv, 2, 1000000), argOrDefault(argc, argv, 3, 1000000));
+    }
+    else if (benchmark == "split") {
+        splitBenchmark(argOrDefault(argc, argv, 2, 1000000), argOrDefault(argc, argv, 3, 100000));
+    }
+    else if (benchmark == "snapshot") {
+        snapshotBenchmark(argOrDefault(argc, argv, 2, 1000000), argOrDefault(argc, argv, 3, 100000));
+    }
+    else if (benchmark == "counted") {
+        countedBenchmark(argOrDefault(argc, argv, 2, 2000000), argOrDefault(argc, argv, 3, 1000));
+    }
+    else if (benchmark == "load") {
+        loadBenchmark(argOrDefault(argc, argv, 2, 10000000), (argc > 3) ? argv[3] : "treebench.snapshot");
+    }
+    else if (benchmark == "batch") {
+        std::vector<long> sizes;
+        for (int i = 2; i < argc; i++) {
+            sizes.push_back(std::atol(argv[i]));
+        }
+        if (sizes.empty()) {
+            sizes = {1000, 100000, 1000000, 10000000};
+        }
+        batchBenchmark(sizes);
+    }
+    else if (benchmark == "move") {
+        moveBenchmark(argOrDefault(argc, argv, 2, 1000000));
+    }
+    else if (benchmark == "compare") {
+        compareBenchmark(argOrDefault(argc, argv, 2, 1000000));
+    }
+    else if (benchmark == "suite") {
+        suiteBenchmark(argOrDefault(argc, argv, 2, 1000000), (argc > 3) ? argv[3] : "int,string,record");
+    }
+    else {
+        std::cerr << "Unknown benchmark: " << benchmark << "\n";
+        return 1;
+    }
+    return (resultMismatches == 0) ? 0 : 1;
+}
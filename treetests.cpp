@@ -0,0 +1,458 @@
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include "BinarySearchTree.h"
+#include "AVLTree.h"
+#include "ArenaSearchTree.h"
+#include "FrozenSearchTree.h"
+#include "BPlusTree.h"
+#include "PersistentSearchTree.h"
+#include "ConcurrentSearchTree.h"
+#include "CountedSearchTree.h"
+#include "TreeSnapshot.h"
+#include "NotFoundException.h"
+
+//Correctness driver for the tree containers. Build with the treetests target
+//of CMakeLists.txt and run it through ctest, or directly with
+//  g++ -std=c++14 -O2 -pthread -o treetests treetests.cpp
+//Each tree is fed the same seeded stream of adds and removes as a std::multiset,
+//and after every round its traversals, counts and lookups must match the multiset.
+//Prints one FAILED line per mismatch and exits non-zero if there was any.
+
+const int KEY_RANGE = 300;          //Keys are drawn from 0..KEY_RANGE-1, so duplicates are common
+const int ROUNDS = 6;
+const int OPERATIONS_PER_ROUND = 1500;
+
+int failures = 0;
+
+void check(bool passed, const std::string& what){
+    if (!passed) {
+        failures++;
+        std::cout << "FAILED: " << what << "\n";
+    }
+}
+
+//Collects the entries of a function-pointer traversal.
+std::vector<int> visitedItems;
+
+void recordItem(int& anItem){
+    visitedItems.push_back(anItem);
+}
+
+template<class TreeType>
+std::vector<int> inorderItems(const TreeType& tree){
+    std::vector<int> items;
+    tree.inorderTraverse([&items](const int& anItem) { items.push_back(anItem); });
+    return items;
+}
+
+//True when getEntry(key) hands back key, and false when it throws or returns another entry.
+template<class TreeType>
+bool getEntryFinds(const TreeType& tree, int key){
+    try {
+        return tree.getEntry(key) == key;
+    }
+    catch (const NotFoundException&) {
+        return false;
+    }
+}
+
+template<class TreeType>
+bool getEntryThrows(const TreeType& tree, int key){
+    try {
+        tree.getEntry(key);
+    }
+    catch (const NotFoundException&) {
+        return true;
+    }
+    return false;
+}
+
+//Adds or removes random keys in both containers, checking what each remove reports.
+template<class TreeType, class Reference>
+void applyStream(const std::string& name, TreeType& tree, Reference& reference, std::mt19937& generator){
+    std::uniform_int_distribution<int> keyDist(0, KEY_RANGE - 1);
+    std::uniform_int_distribution<int> operationDist(0, 9);
+    for (int operation = 0; operation < OPERATIONS_PER_ROUND; operation++) {
+        int key = keyDist(generator);
+        if (operationDist(generator) < 6) {
+            tree.add(key);
+            reference.insert(key);
+        } else {
+            auto position = reference.find(key);
+            bool present = (position != reference.end());
+            if (present) {
+                reference.erase(position);
+            }
+            check(tree.remove(key) == present, name + " remove(" + std::to_string(key) + ") result");
+        }
+    }
+}
+
+//Checks the sorted traversal and every lookup against the reference.
+template<class TreeType, class Reference>
+void checkContents(const std::string& name, const TreeType& tree, const Reference& reference){
+    std::vector<int> expected(reference.begin(), reference.end());
+    check(inorderItems(tree) == expected, name + " inorder traversal");
+    check(tree.isEmpty() == reference.empty(), name + " isEmpty()");
+    for (int key = -1; key <= KEY_RANGE; key++) {
+        bool present = (reference.count(key) > 0);
+        check(tree.contains(key) == present, name + " contains(" + std::to_string(key) + ")");
+        if (present) {
+            check(getEntryFinds(tree, key), name + " getEntry(" + std::to_string(key) + ")");
+        } else {
+            check(getEntryThrows(tree, key), name + " getEntry(" + std::to_string(key) + ") of an absent key");
+        }
+    }
+}
+
+//Checks the traversals declared by BinaryTreeInterface, which take a function pointer.
+void checkInterfaceTraversals(const std::string& name, const BinaryTreeInterface<int>& tree,
+                              const std::vector<int>& expected){
+    visitedItems.clear();
+    tree.inorderTraverse(recordItem);
+    check(visitedItems == expected, name + " inorderTraverse(function)");
+
+    //Pre- and postorder visit the same entries in another order
+    std::vector<int> sortedExpected(expected);
+    std::sort(sortedExpected.begin(), sortedExpected.end());
+    visitedItems.clear();
+    tree.preorderTraverse(recordItem);
+    std::sort(visitedItems.begin(), visitedItems.end());
+    check(visitedItems == sortedExpected, name + " preorderTraverse(function)");
+    visitedItems.clear();
+    tree.postorderTraverse(recordItem);
+    std::sort(visitedItems.begin(), visitedItems.end());
+    check(visitedItems == sortedExpected, name + " postorderTraverse(function)");
+}
+
+//Runs the stream on a tree whose getNumberOfNodes counts every copy of an entry.
+template<class TreeType, class Reference>
+void testTree(const std::string& name, TreeType& tree, Reference& reference, unsigned seed){
+    std::mt19937 generator(seed);
+    for (int round = 0; round < ROUNDS; round++) {
+        applyStream(name, tree, reference, generator);
+        checkContents(name, tree, reference);
+        check(tree.getNumberOfNodes() == static_cast<int>(reference.size()), name + " getNumberOfNodes()");
+    }
+}
+
+//The ordered queries, iterators and read-only copies of a BinarySearchTree.
+template<class TreeType, class Reference>
+void checkOrderedQueries(const std::string& name, const TreeType& tree, const Reference& reference){
+    std::vector<int> expected(reference.begin(), reference.end());
+    checkInterfaceTraversals(name, tree, expected);
+    check(std::vector<int>(tree.begin(), tree.end()) == expected, name + " iterators");
+
+    for (int key = -1; key <= KEY_RANGE; key++) {
+        std::string label = "(" + std::to_string(key) + ")";
+        auto lower = reference.lower_bound(key);
+        auto upper = reference.upper_bound(key);
+        int below = static_cast<int>(std::distance(reference.begin(), lower));
+        auto treeLower = tree.lower_bound(key);
+        auto treeUpper = tree.upper_bound(key);
+        check((lower == reference.end()) ? (treeLower == tree.end()) : (treeLower != tree.end() && *treeLower == *lower),
+              name + " lower_bound" + label);
+        check((upper == reference.end()) ? (treeUpper == tree.end()) : (treeUpper != tree.end() && *treeUpper == *upper),
+              name + " upper_bound" + label);
+        check(tree.countLess(key) == below, name + " countLess" + label);
+
+        //[lo, hi) runs the way the tree is ordered
+        int lo = key;
+        int hi = key + 5;
+        if (reference.key_comp()(hi, lo)) {
+            std::swap(lo, hi);
+        }
+        int inRange = static_cast<int>(std::distance(reference.lower_bound(lo), reference.lower_bound(hi)));
+        check(tree.rangeCount(lo, hi) == inRange, name + " rangeCount" + label);
+    }
+    for (int position = 0; position < static_cast<int>(expected.size()); position += 7) {
+        check(tree.select(position) == expected[position], name + " select(" + std::to_string(position) + ")");
+    }
+
+    auto frozen = tree.freeze();
+    checkContents(name + " freeze()", frozen, reference);
+    check(frozen.getNumberOfNodes() == static_cast<int>(reference.size()), name + " freeze() getNumberOfNodes()");
+}
+
+//Orders entries the opposite way to Order.
+template<class Order>
+struct ReversedOrder {
+    Order order;
+
+    bool operator()(int leftItem, int rightItem) const {
+        return order(rightItem, leftItem);
+    }
+};
+
+template<class Order>
+bool snapshotRefused(const std::string& fileName, const Order& order){
+    try {
+        MappedSnapshot<int, ReversedOrder<Order>> snapshot(fileName, true, ReversedOrder<Order>{order});
+    }
+    catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+//Writes the tree to a snapshot file and searches the mapped copy.
+template<class TreeType, class Reference>
+void checkSnapshot(const std::string& name, const TreeType& tree, const Reference& reference){
+    const std::string fileName = "treetests.snapshot";
+    writeSnapshot(tree, fileName);
+    {
+        MappedSnapshot<int, typename Reference::key_compare> snapshot(fileName, true, reference.key_comp());
+        std::vector<int> expected(reference.begin(), reference.end());
+        check(std::vector<int>(snapshot.begin(), snapshot.end()) == expected, name + " snapshot entries");
+        check(snapshot.getNumberOfNodes() == static_cast<int>(reference.size()), name + " snapshot getNumberOfNodes()");
+        for (int key = -1; key <= KEY_RANGE; key++) {
+            check(snapshot.contains(key) == (reference.count(key) > 0),
+                  name + " snapshot contains(" + std::to_string(key) + ")");
+        }
+    }
+    if (!reference.empty() && reference.count(*reference.begin()) < reference.size()) {
+        check(snapshotRefused(fileName, reference.key_comp()), name + " snapshot mapped with the reverse ordering");
+    }
+    std::remove(fileName.c_str());
+}
+
+//Splits a copy of the tree at a few keys and joins the parts back.
+template<class TreeType, class Reference>
+void checkSplitJoin(const std::string& name, const TreeType& tree, const Reference& reference){
+    for (int key : {-1, KEY_RANGE / 3, KEY_RANGE / 2, KEY_RANGE}) {
+        std::string label = " split(" + std::to_string(key) + ")";
+        TreeType lowerPart(tree);
+        TreeType upperPart;
+        lowerPart.split(key, upperPart);
+        Reference lowerReference(reference.begin(), reference.lower_bound(key));
+        Reference upperReference(reference.lower_bound(key), reference.end());
+        checkContents(name + label + " lower part", lowerPart, lowerReference);
+        checkContents(name + label + " upper part", upperPart, upperReference);
+        lowerPart.join(upperPart);
+        checkContents(name + label + " then join()", lowerPart, reference);
+        check(upperPart.isEmpty(), name + label + " join() empties the upper part");
+        checkContents(name + label + " original", tree, reference);
+    }
+}
+
+//Checks the set operations against multiset counts, using a second stream for the other tree.
+template<class TreeType, class Reference>
+void checkSetOperations(const std::string& name, const TreeType& tree, const Reference& reference, unsigned seed){
+    TreeType otherTree;
+    Reference otherReference(reference.key_comp());
+    std::mt19937 generator(seed);
+    applyStream(name + " other", otherTree, otherReference, generator);
+
+    Reference merged(reference);
+    merged.insert(otherReference.begin(), otherReference.end());
+    Reference unioned(reference.key_comp());
+    Reference intersected(reference.key_comp());
+    Reference subtracted(reference.key_comp());
+    for (int key = 0; key < KEY_RANGE; key++) {
+        int ours = static_cast<int>(reference.count(key));
+        int theirs = static_cast<int>(otherReference.count(key));
+        for (int copy = 0; copy < std::max(ours, theirs); copy++) {
+            unioned.insert(key);
+        }
+        for (int copy = 0; copy < std::min(ours, theirs); copy++) {
+            intersected.insert(key);
+        }
+        for (int copy = 0; copy < ours - theirs; copy++) {
+            subtracted.insert(key);
+        }
+    }
+
+    TreeType result(tree);
+    TreeType other(otherTree);
+    result.mergeFrom(other);
+    checkContents(name + " mergeFrom()", result, merged);
+    check(other.isEmpty(), name + " mergeFrom() empties the other tree");
+
+    result = tree;
+    other = otherTree;
+    result.unionWith(other);
+    checkContents(name + " unionWith()", result, unioned);
+    check(other.isEmpty(), name + " unionWith() empties the other tree");
+
+    result = tree;
+    result.intersectWith(otherTree);
+    checkContents(name + " intersectWith()", result, intersected);
+
+    result = tree;
+    result.subtract(otherTree);
+    checkContents(name + " subtract()", result, subtracted);
+
+    checkContents(name + " after set operations", tree, reference);
+    checkContents(name + " other after set operations", otherTree, otherReference);
+}
+
+template<class TreeType, class Reference>
+void testSearchTree(const std::string& name, unsigned seed){
+    TreeType tree;
+    Reference reference;
+    testTree(name, tree, reference, seed);
+    checkOrderedQueries(name, tree, reference);
+    checkSnapshot(name, tree, reference);
+    checkSplitJoin(name, tree, reference);
+    checkSetOperations(name, tree, reference, seed + 1);
+}
+
+//Every AVL subtree stays within 1.44 log2(n + 2) levels.
+template<class TreeType>
+void checkBalanced(const std::string& name, const TreeType& tree){
+    double bound = 1.4405 * std::log2(tree.getNumberOfNodes() + 2.0);
+    check(tree.getHeight() <= bound, name + " height " + std::to_string(tree.getHeight()) + " within the AVL bound");
+}
+
+//Older versions keep their entries while newer ones change.
+void testPersistentVersions(unsigned seed){
+    const std::string name = "PersistentSearchTree versions";
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> keyDist(0, KEY_RANGE - 1);
+    std::vector<PersistentSearchTree<int>> versions(1);
+    std::vector<std::multiset<int>> references(1);
+    for (int step = 0; step < 200; step++) {
+        int key = keyDist(generator);
+        std::multiset<int> reference(references.back());
+        if (step % 3 == 2) {
+            versions.push_back(versions.back().removed(key));
+            auto position = reference.find(key);
+            if (position != reference.end()) {
+                reference.erase(position);
+            }
+        } else {
+            versions.push_back(versions.back().added(key));
+            reference.insert(key);
+        }
+        references.push_back(reference);
+    }
+
+    //Changing a copy in place must not reach the version it was copied from
+    PersistentSearchTree<int> copy(versions.back());
+    std::multiset<int> copyReference(references.back());
+    applyStream(name + " copy", copy, copyReference, generator);
+
+    for (std::size_t version = 0; version < versions.size(); version += 10) {
+        checkContents(name + " #" + std::to_string(version), versions[version], references[version]);
+    }
+    checkContents(name + " latest", versions.back(), references.back());
+    checkContents(name + " copy", copy, copyReference);
+}
+
+//CountedSearchTree keeps one node per distinct entry.
+void testCountedTree(unsigned seed){
+    const std::string name = "CountedSearchTree";
+    CountedSearchTree<int> tree;
+    std::multiset<int> reference;
+    std::mt19937 generator(seed);
+    for (int round = 0; round < ROUNDS; round++) {
+        applyStream(name, tree, reference, generator);
+        checkContents(name, tree, reference);
+        std::set<int> distinct(reference.begin(), reference.end());
+        check(tree.getNumberOfEntries() == static_cast<int>(reference.size()), name + " getNumberOfEntries()");
+        check(tree.getNumberOfNodes() == static_cast<int>(distinct.size()), name + " getNumberOfNodes()");
+        for (int key = -1; key <= KEY_RANGE; key++) {
+            check(tree.count(key) == static_cast<int>(reference.count(key)), name + " count(" + std::to_string(key) + ")");
+        }
+    }
+    checkInterfaceTraversals(name, tree, std::vector<int>(reference.begin(), reference.end()));
+
+    for (int key = 0; key < KEY_RANGE; key += 5) {
+        int copies = static_cast<int>(reference.erase(key));
+        check(tree.removeAll(key) == copies, name + " removeAll(" + std::to_string(key) + ")");
+    }
+    checkContents(name + " after removeAll()", tree, reference);
+}
+
+//ArenaSearchTree and BinarySearchTree place and remove nodes the same way,
+//so the arena's cached heights must follow the pointer tree's after every step.
+void checkArenaHeights(unsigned seed){
+    ArenaSearchTree<int> arenaTree;
+    BinarySearchTree<int> pointerTree;
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> keyDist(0, KEY_RANGE - 1);
+    std::uniform_int_distribution<int> operationDist(0, 9);
+    int mismatches = 0;
+    for (int operation = 0; operation < ROUNDS * OPERATIONS_PER_ROUND; operation++) {
+        int key = keyDist(generator);
+        if (operationDist(generator) < 6) {
+            arenaTree.add(key);
+            pointerTree.add(key);
+        } else {
+            arenaTree.remove(key);
+            pointerTree.remove(key);
+        }
+        mismatches += (arenaTree.getHeight() != pointerTree.getHeight()) ? 1 : 0;
+    }
+    check(mismatches == 0, "ArenaSearchTree getHeight() after " + std::to_string(mismatches) + " steps");
+}
+
+//Trees with a transparent ordering find std::string entries by const char* keys.
+template<class TreeType>
+void checkTransparentLookups(const std::string& name, TreeType& tree){
+    for (const char* word : {"pear", "apple", "fig", "apple"}) {
+        tree.add(word);
+    }
+    check(tree.contains("apple") && tree.contains("fig") && !tree.contains("plum"), name + " contains(const char*)");
+    check(tree.getEntry("pear") == "pear", name + " getEntry(const char*)");
+}
+
+int main()
+{
+    testSearchTree<BinarySearchTree<int>, std::multiset<int>>("BinarySearchTree", 11);
+    testSearchTree<AVLTree<int>, std::multiset<int>>("AVLTree", 12);
+    testSearchTree<AVLTree<int, std::greater<int>>, std::multiset<int, std::greater<int>>>("AVLTree greater", 13);
+    testSearchTree<PersistentSearchTree<int>, std::multiset<int>>("PersistentSearchTree", 14);
+    testSearchTree<PersistentSearchTree<int, std::greater<int>>, std::multiset<int, std::greater<int>>>(
+            "PersistentSearchTree greater", 21);
+    testPersistentVersions(15);
+
+    PersistentSearchTree<std::string, DefaultOrder<>> persistentWords;
+    checkTransparentLookups("PersistentSearchTree", persistentWords);
+    ConcurrentSearchTree<std::string, DefaultOrder<>> concurrentWords;
+    checkTransparentLookups("ConcurrentSearchTree", concurrentWords);
+
+    AVLTree<int> avlTree;
+    std::multiset<int> avlReference;
+    testTree("AVLTree balance", avlTree, avlReference, 16);
+    checkBalanced("AVLTree", avlTree);
+
+    ConcurrentSearchTree<int> concurrentTree;
+    std::multiset<int> concurrentReference;
+    testTree("ConcurrentSearchTree", concurrentTree, concurrentReference, 17);
+    checkBalanced("ConcurrentSearchTree", concurrentTree);
+
+    ConcurrentSearchTree<int, std::greater<int>> concurrentGreaterTree;
+    std::multiset<int, std::greater<int>> concurrentGreaterReference;
+    testTree("ConcurrentSearchTree greater", concurrentGreaterTree, concurrentGreaterReference, 22);
+
+    ArenaSearchTree<int> arenaTree;
+    std::multiset<int> arenaReference;
+    testTree("ArenaSearchTree", arenaTree, arenaReference, 18);
+    checkInterfaceTraversals("ArenaSearchTree", arenaTree,
+                             std::vector<int>(arenaReference.begin(), arenaReference.end()));
+    checkArenaHeights(23);
+
+    BPlusTree<int> wideTree;
+    std::multiset<int> wideReference;
+    testTree("BPlusTree", wideTree, wideReference, 19);
+    checkInterfaceTraversals("BPlusTree", wideTree, std::vector<int>(wideReference.begin(), wideReference.end()));
+
+    testCountedTree(20);
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}